@@ -35,6 +35,16 @@ class Bitset final : Sequence<bool, uint64_t> {
         return static_cast<bool>(i & (BlockTypeOne << b));
     }
 
+    /**
+     * @return bits [64w, 64w+64) of the storage (little-endian block order)
+     */
+    uint64_t word(uint64_t w) const;
+
+    /**
+     * Overwrite the bits of word(w) that are selected by mask with x.
+     */
+    void setWord(uint64_t w, uint64_t x, uint64_t mask);
+
  public:
     static const uint64_t npos = std::numeric_limits<uint64_t>::max();
 
@@ -101,6 +111,46 @@ class Bitset final : Sequence<bool, uint64_t> {
         return mbits.capacity()*sizeof(BlockType);
     }
 
+    /**
+     * @param bits number of bits
+     * @return byteSize() of a bitset with the given number of bits
+     */
+    static uint64_t estimateByteSize(uint64_t bits) {
+        return (bits / bitsPerBlock + (bits % bitsPerBlock != 0)) *
+               sizeof(BlockType);
+    }
+
+    /**
+     * Count the set bits in a range, a word at a time.
+     * @param from index of the first bit of the range
+     * @param to index behind the last bit of the range (<= size())
+     * @return number of set bits in [from, to)
+     */
+    uint64_t count(uint64_t from, uint64_t to) const;
+
+    /**
+     * Find the next set bit, skipping a word of clear bits at a time.
+     * @param from index to start the search at
+     * @return index of the first set bit >= from, npos if there is none
+     */
+    uint64_t next(uint64_t from) const;
+
+    /**
+     * Read up to 64 consecutive bits at once.
+     * @param from index of the first bit
+     * @param len number of bits (<= 64, from + len <= size())
+     * @return the bits [from, from+len), bit from as the lowest one
+     */
+    uint64_t getBits(uint64_t from, uint64_t len) const;
+
+    /**
+     * Overwrite up to 64 consecutive bits at once.
+     * @param from index of the first bit
+     * @param len number of bits (<= 64, from + len <= size())
+     * @param x the new bits [from, from+len), bit from as the lowest one
+     */
+    void setBits(uint64_t from, uint64_t len, uint64_t x);
+
     /**
      * Proxy class to simulate lvalues of bit type.
      * Implementation taken from boost dynamic_bitset.
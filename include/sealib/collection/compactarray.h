@@ -1,6 +1,7 @@
 #ifndef SEALIB_COLLECTION_COMPACTARRAY_H_
 #define SEALIB_COLLECTION_COMPACTARRAY_H_
 
+#include <iosfwd>
 #include <vector>
 #include "sealib/_types.h"
 #include "sealib/collection/bitset.h"
@@ -47,10 +48,42 @@ class CompactArray : public Sequence<uint64_t> {
      */
     void reset();
 
+    /**
+     * Replace every occurrence of a value by another value. If the value
+     * width divides the word size, a whole word is processed at once.
+     * EFFICIENCY: O(n/w) word operations (if log(v) divides 64), O(n)
+     * otherwise
+     * @param from the value to replace
+     * @param to the new value
+     */
+    void replaceAll(uint64_t from, uint64_t to);
+
+    /**
+     * Write the size, the value width and the packed values to a binary
+     * stream.
+     * @param out the stream to write to
+     */
+    void save(std::ostream *out) const;
+
+    /**
+     * Read values that were written by save(). The stored array must have
+     * the same size and value width as this one.
+     * @param in the stream to read from
+     * @return true on success, false if the stored array does not match
+     */
+    bool load(std::istream *in);
+
     uint64_t byteSize() const { return data.capacity() * sizeof(uint64_t); }
 
+    /**
+     * @param size number of values
+     * @param v number of states for one value
+     * @return byteSize() of a compact array created with these parameters
+     */
+    static uint64_t estimateByteSize(uint64_t size, uint64_t v = 3);
+
  private:
-    uint64_t valueWidth, singleMask;
+    uint64_t elements, valueWidth, singleMask;
     std::vector<uint64_t> data;
 };
 }  // namespace Sealib
@@ -1,6 +1,7 @@
 #ifndef SEALIB_COLLECTION_SEGMENTSTACK_H_
 #define SEALIB_COLLECTION_SEGMENTSTACK_H_
 
+#include <iosfwd>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -18,6 +19,8 @@ class VisualDFS;
 #endif  // SEALIBVISUAL_EXAMPLES_H
 
 namespace Sealib {
+struct DFSStats;
+
 /*
   Segment Stack:
   - the segment stack has a low and a high segment
@@ -54,12 +57,35 @@ class SegmentStack {
     virtual bool isAligned() = 0;
     virtual ~SegmentStack() = default;
 
+    /**
+     * Write the contents of the stack to a binary stream. Only the occupied
+     * slots of the segments are written.
+     * @param out the stream to write to
+     */
+    virtual void save(std::ostream *out) const;
+    /**
+     * Read the contents of a stack that was written by save(). The stack
+     * must have been created with the same parameters.
+     * @param in the stream to read from
+     * @return true on success, false if the stored stack does not match
+     */
+    virtual bool load(std::istream *in);
+
+    /**
+     * Attach a statistics object that the stack and the restoration
+     * procedures fill in (nullptr to disable the statistics).
+     * @param s statistics to fill in
+     */
+    void setStats(DFSStats *s) { stats = s; }
+    DFSStats *getStats() const { return stats; }
+
  protected:
     explicit SegmentStack(uint64_t segmentSize);
 
     uint64_t q;
     std::vector<std::pair<uint64_t, uint64_t>> low, high;
     uint64_t lp, hp, tp;
+    DFSStats *stats = nullptr;
 };
 
 /**
@@ -70,10 +96,21 @@ class SegmentStack {
  * 2q entries on the segment stack shall take up at most (ε/3)n bits, thus each
  * segment has a size of ((ε/6)n)/bitsize(ENTRY) bits, where bitsize(x) is the
  * number of bits a type occupies (e.g. bitsize(uint64_t)=32).
+ *
+ * If memory allows, the stack can keep copies of the most recently dropped
+ * segments (checkpoints). A restoration then only reloads the newest
+ * checkpoint, and the DFS is replayed from the root only when all
+ * checkpoints are used up. The trailer always belongs to the newest segment
+ * that was dropped without a checkpoint.
  */
 class BasicSegmentStack : public SegmentStack {
  public:
-    explicit BasicSegmentStack(uint64_t segmentSize);
+    /**
+     * @param segmentSize number of tuples in a segment
+     * @param checkpoints number of dropped segments that are kept as
+     * checkpoints (each needs the space of one segment)
+     */
+    explicit BasicSegmentStack(uint64_t segmentSize, uint64_t checkpoints = 0);
 
     /**
      * Push a tuple on the stack.
@@ -95,10 +132,36 @@ class BasicSegmentStack : public SegmentStack {
      */
     void saveTrailer();
 
+    /**
+     * Reload the newest checkpoint into the low segment.
+     * @return true if a checkpoint was reloaded, false if there is none (a
+     * full restoration is necessary)
+     */
+    bool restoreCheckpoint();
+
+    void save(std::ostream *out) const override;
+    bool load(std::istream *in) override;
+
+    uint64_t byteSize() const {
+        return (low.capacity() + high.capacity() + saved.capacity()) *
+               sizeof(std::pair<uint64_t, uint64_t>);
+    }
+
+    /**
+     * @return byteSize() of a stack created with the given parameters
+     */
+    static uint64_t estimateByteSize(uint64_t segmentSize,
+                                     uint64_t checkpoints = 0) {
+        return (2 + checkpoints) * segmentSize *
+               sizeof(std::pair<uint64_t, uint64_t>);
+    }
+
  private:
     std::pair<uint64_t, uint64_t> last;
     std::pair<uint64_t, uint64_t> savedTrailer;
     int alignTarget;
+    std::vector<std::pair<uint64_t, uint64_t>> saved;
+    uint64_t cMax, cFirst, cCount;
 };
 
 /**
@@ -183,6 +246,9 @@ class ExtendedSegmentStack : public SegmentStack {
      */
     uint64_t retrieveEdge(uint64_t u, uint64_t f);
 
+    void save(std::ostream *out) const override;
+    bool load(std::istream *in) override;
+
     uint64_t byteSize() const {
         return (low.capacity() + high.capacity() + big.capacity()) *
                    sizeof(std::pair<uint64_t, uint64_t>) +
@@ -190,6 +256,12 @@ class ExtendedSegmentStack : public SegmentStack {
                edges.byteSize();
     }
 
+    /**
+     * @param size number of vertices of the graph
+     * @return byteSize() of a stack created for a graph of the given size
+     */
+    static uint64_t estimateByteSize(uint64_t size);
+
  private:
     /**
      * A Trailer struct additionally manages a sequence of big vertices.
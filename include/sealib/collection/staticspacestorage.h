@@ -61,6 +61,16 @@ class StaticSpaceStorage : public Sequence<uint64_t> {
         return rankSelect.byteSize() + storage.capacity() * sizeof(uint64_t);
     }
 
+    /**
+     * @param entries number of entries
+     * @param dataBits total number of bits reserved for the entries
+     * @return byteSize() of a storage with the given layout
+     */
+    static uint64_t estimateByteSize(uint64_t entries, uint64_t dataBits) {
+        return RankSelect::estimateByteSize(entries + dataBits, entries) +
+               (dataBits / WORD_SIZE + 1) * sizeof(uint64_t);
+    }
+
  private:
     uint64_t n, nb;
     RankSelect rankSelect;
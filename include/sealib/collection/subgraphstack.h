@@ -4,7 +4,9 @@
 #include <sealib/graph/undirectedgraph.h>
 #include <sealib/collection/bitset.h>
 #include <sealib/dictionary/rankselect.h>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <tuple>
@@ -23,30 +25,96 @@ namespace Sealib {
  * All operations can be evaluated in effectively constant time, the subgraphs that are being pushed
  * are represented by various bitsets with at most O(|V_0| + 2|E_0|) size
  * for which we construct additional rank-select structures.
+ * A pushed graph is not stored relative to its direct parent, but relative
+ * to a reference graph G_r: the graphs G_r+1,...,G_r' share the reference
+ * G_r, where r' is the next reference level. The sequence of reference
+ * levels is chosen by a ReferencePolicy and grows with the stack, so the
+ * stack has no depth limit.
+ * The stack is not thread-safe, not even for const calls: phi and psi count
+ * the translations they make and may build or drop a cached translation.
  */
 class SubGraphStack {
     friend class SubGraph;
     friend class RecursiveSubGraph;
     friend class BaseSubGraph;
  private:
-    static constexpr uint8_t rSize = 7;
-    static std::vector<uint64_t> refs;
+    // reference levels r_0 = 0 < r_1 < ..., extended on demand by nextRef
+    std::vector<uint64_t> refs;
+    std::function<uint64_t(uint64_t)> nextRef;
     std::vector<SubGraph *> clientList;
     uint64_t currentRef;
-    uint64_t tuned;
 
-    RankSelect *tunedPhi0;
-    RankSelect *tunedPsi0;
-    RankSelect *tunedPhi;
-    RankSelect *tunedPsi;
-
-    void tunephi0(uint64_t i);
-    void tunepsi0(uint64_t i);
-    void tunephi(uint64_t i);
-    void tunepsi(uint64_t i);
+    /**
+     * A direct translation between G_high and G_low: the bitset marks the
+     * vertices (or arcs) of G_high in G_low.
+     */
+    struct Shortcut {
+        bool pinned;  // made by tune(), does not count against the budget
+        uint64_t hits;
+        std::unique_ptr<RankSelect> map;
+    };
+    /**
+     * @return the key of the translations between G_high and G_low in
+     * shortcuts and misses
+     */
+    static uint64_t key(uint64_t high, uint64_t low, bool arcs) {
+        return high << 33 | low << 1 | arcs;
+    }
+    // translations are only ever cached, so they may be built in const calls
+    mutable std::unordered_map<uint64_t, Shortcut> shortcuts;
+    // number of translations per level pair that had to walk the references
+    mutable std::unordered_map<uint64_t, uint64_t> misses;
+    uint64_t budget;
+    mutable uint64_t used;
+
+    uint64_t translate(uint64_t i, uint64_t j, uint64_t x, bool arcs) const;
+    uint64_t walkPhi(uint64_t i, uint64_t j, uint64_t u) const;
+    uint64_t walkPsi(uint64_t i, uint64_t j, uint64_t a) const;
+    void materialize(uint64_t high, uint64_t low, bool arcs,
+                     bool pinned) const;
+    bool makeRoom(uint64_t size, uint64_t hits) const;
+    uint64_t reference();
 
  public:
-    explicit SubGraphStack(std::shared_ptr<UndirectedGraph> g_);
+    /**
+     * Given a reference level r_k, a policy returns the next reference level
+     * r_k+1 (a value <= r_k is treated as r_k + 1). Rare reference levels
+     * keep the chains that phi and psi walk short, but every graph stores
+     * bitsets as long as its reference graph; frequent reference levels make
+     * the bitsets shrink with the graphs, and the chains longer.
+     */
+    typedef std::function<uint64_t(uint64_t)> ReferencePolicy;
+
+    /**
+     * Reference levels 0, 1, 3, 15, 65535: r_k+1 = 2^(r_k + 1) - 1.
+     * phi and psi walk at most four references (the default).
+     */
+    static ReferencePolicy tetration();
+
+    /**
+     * Reference levels r_k+1 = base * r_k + 1, i.e. O(log_base(l)) references
+     * for a stack of depth l; base 1 makes every graph the reference of the
+     * next one.
+     * @param base growth factor of the reference levels
+     */
+    static ReferencePolicy geometric(uint64_t base);
+
+    /**
+     * Selects vertices u (1 <= u <= n_l) of the top graph G_l.
+     */
+    typedef std::function<bool(uint64_t)> VertexPredicate;
+
+    /**
+     * Selects arcs (u, k) (1 <= k <= deg(u)) of the top graph G_l.
+     */
+    typedef std::function<bool(uint64_t, uint64_t)> ArcPredicate;
+
+    /**
+     * @param g_ the graph G_0
+     * @param policy chooses the reference levels (default: tetration())
+     */
+    explicit SubGraphStack(std::shared_ptr<UndirectedGraph> g_,
+                           ReferencePolicy policy = tetration());
     /**
      * Pushes a new subgraph G_l+1 on G_l.
      * i.e. replaces the client list (G_0,...,G_l) with (G_0,...,G_l,G_l+1)
@@ -71,6 +139,29 @@ class SubGraphStack {
     void push(const Sealib::Bitset<uint8_t> &a);
     void push(Bitset<uint8_t> &&a);
 
+    /**
+     * Pushes a new subgraph G_l+1 on G_l without building bitsets for it:
+     * the predicates are evaluated once per vertex and arc of G_l, in order,
+     * and G_l+1 is built directly from their answers.
+     * The arc predicate is only asked about arcs of kept vertices; as with
+     * the bitset version, an arc and its mate must both be kept or dropped.
+     * @param v v(u) is true iff the vertex u of G_l is kept
+     * @param a a(u, k) is true iff the k-th arc of u in G_l is kept
+     */
+    void push(const VertexPredicate &v, const ArcPredicate &a);
+
+    /**
+     * Pushes the subgraph of G_l that is induced by a set of vertices: a
+     * kept vertex keeps exactly the arcs to other kept vertices.
+     * @param v v(u) is true iff the vertex u of G_l is kept
+     */
+    void pushInduced(const VertexPredicate &v);
+
+    /**
+     * @param v Bitsequence of length n_l, the vertices that are kept
+     */
+    void pushInduced(const Sealib::Bitset<uint8_t> &v);
+
     /**
      * Replaces the client list (G_0,...,G_l) with (G_0,...,G_l-1).
      * Asserts that the client list is not empty.
@@ -160,11 +251,13 @@ class SubGraphStack {
     }
 
     /**
+     * Not thread-safe: updates the cached translations (see tune()).
      * @return translation of the u'th node in G_i to the isomorph node in G_j
      */
     uint64_t phi(uint64_t i, uint64_t j, uint64_t u) const;
 
     /**
+     * Not thread-safe: updates the cached translations (see tune()).
      * @return translation of the a'th arc in G_i to the isomorph arc in G_j
      */
     uint64_t psi(uint64_t i, uint64_t j, uint64_t a)const;
@@ -212,24 +305,47 @@ class SubGraphStack {
     }
 
     /**
-     * Speeds up the calls of phi, psi, g, gInv, head, mate, order and degree
-     * for the graph G_l that is currently on the top of the stack.
-     * This is done by creating rankSelect structures for the direct translation between G_0 and G_l and G_l and G_l - 1
+     * Speeds up the calls of phi and psi between the graph G_l that is
+     * currently on the top of the stack and G_0 or G_l-1 (see tune()).
      */
     inline void toptune() {
         tune(clientList.size()-1);
     }
 
     /**
-     * Speeds up the calls of phi, psi, g, gInv, head, mate, order and degree
-     * for the graph G_i
-     * This is done by creating rankSelect structures for the direct translation between G_0 and G_i, and G_i and G_i - 1
+     * Speeds up the calls of phi and psi between G_i and G_0, and between
+     * G_i and G_i-1.
+     * This is done by creating rankSelect structures for the direct
+     * translation. They are kept until G_i is popped or tune() is called
+     * again, and do not count against the tuning budget.
      *
-     * If there are previously initialized tuning structures, they are destroyed.
+     * Translations between other pairs of graphs are tuned automatically:
+     * once a pair has been translated about as often as G_i has vertices (or
+     * arcs), the direct translation is built if it fits into the budget.
+     * Less used translations are dropped to make room for it.
      * @param i - idx of the Graph to be tuned
      */
     void tune(uint64_t i);
 
+    /**
+     * Sets the number of bytes that automatically built translations may
+     * use (default: 24 bits per vertex and arc of G_0, which is room for two
+     * translations of each kind into G_0; 0 turns them off).
+     * @param bytes the new budget
+     */
+    void setTuningBudget(uint64_t bytes);
+
+    /**
+     * @return the number of bytes used by the direct translations
+     */
+    uint64_t tuningByteSize() const;
+
+    /**
+     * @return the number of bytes used by the graphs on the stack (without
+     * G_0 itself) and by the direct translations
+     */
+    uint64_t byteSize() const;
+
     /**
      * @return the number of graphs currently on the stack
      */
@@ -56,6 +56,14 @@ union VariantBitset {
 
     uint64_t byteSize() const { return bit.capacity() / 8; }
 
+    /**
+     * @param bits number of bits
+     * @return byteSize() of a bitset with the given number of bits
+     */
+    static uint64_t estimateByteSize(uint64_t bits) {
+        return (bits / 64 + (bits % 64 != 0)) * sizeof(uint64_t);
+    }
+
     VariantBitset(VariantBitset const &);
     VariantBitset(VariantBitset &&);
     VariantBitset &operator=(VariantBitset const &);
@@ -48,6 +48,16 @@ class RankSelectBase {
         return rankStructure.byteSize() + firstInSegment.byteSize();
     }
 
+    /**
+     * @param bits size of the bitset
+     * @param ones number of set bits
+     * @return byteSize() of a rank-select structure over such a bitset
+     */
+    static uint64_t estimateByteSize(uint64_t bits, uint64_t ones) {
+        return RankStructureBase<B>::estimateByteSize(bits) +
+               RankStructureBase<B>::estimateByteSize(ones);
+    }
+
     B const &getBitset() const { return rankStructure.getBitset(); }
 
  private:
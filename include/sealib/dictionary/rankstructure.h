@@ -78,6 +78,15 @@ class RankStructureBase {
                    sizeof(uint32_t);
     }
 
+    /**
+     * @param bits size of the bitset
+     * @return byteSize() of a rank structure over a bitset of the given size
+     */
+    static uint64_t estimateByteSize(uint64_t bits) {
+        uint64_t segments = bits / segmentLength + (bits % segmentLength != 0);
+        return B::estimateByteSize(bits) + 2 * segments * sizeof(uint32_t);
+    }
+
  protected:
     static constexpr const uint8_t segmentLength = 8;
     B const bitset;
@@ -0,0 +1,136 @@
+#ifndef SEALIB_GRAPH_EXTERNALGRAPH_H_
+#define SEALIB_GRAPH_EXTERNALGRAPH_H_
+
+#include <exception>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sealib/_types.h"
+#include "sealib/graph/graph.h"
+
+namespace Sealib {
+
+/**
+ * I/O counters of an external graph.
+ */
+struct ExternalGraphStats {
+    uint64_t requests = 0;   ///< number of read requests sent to the file
+    uint64_t bytesRead = 0;  ///< number of bytes read from the file
+    uint64_t hits = 0;       ///< word accesses served by the cache
+    uint64_t misses = 0;     ///< word accesses that needed a read request
+};
+
+/**
+ * A graph whose adjacency arrays stay on disk (semi-external mode). Any
+ * algorithm that works on a Graph can run on it: the vertex state of the
+ * algorithm (colors, segment stack, choice dictionaries, ...) stays in
+ * memory, while the adjacency structure is read through a block cache of a
+ * fixed size.
+ *
+ * On a cache miss, the missing block and a number of following blocks are
+ * read with one sequential request (read-ahead). The traversals in this
+ * library scan the adjacency array of a vertex in order, so the read-ahead
+ * follows the traversal. Blocks are replaced with the clock strategy; blocks
+ * that were read ahead but not used yet are replaced first.
+ *
+ * The file contains n, m, the n+1 offsets of the adjacency arrays and the m
+ * heads as 64-bit words (in the byte order of the machine); create it with
+ * write().
+ * The graph is not thread-safe, since every access may modify the cache.
+ *
+ * Example:
+ *   ExternalGraph::write(GraphCreator::kOutdegree(1000, 10), "g.bin");
+ *   ExternalGraph g("g.bin", 1 << 20);
+ *   DFS::nloglognBitDFS(g);
+ *   printf("%lu bytes read\n", g.getStats().bytesRead);
+ */
+class ExternalGraph : public Graph {
+ public:
+    /**
+     * Open a graph file.
+     * @param path the file written by write()
+     * @param cacheBytes size of the block cache in bytes
+     * @param blockBytes size of a block in bytes (a multiple of 8)
+     * @param readAhead number of blocks that are read after a missing block
+     * @throws ExternalGraphError if the file cannot be read
+     */
+    explicit ExternalGraph(std::string const &path,
+                           uint64_t cacheBytes = 1 << 24,
+                           uint64_t blockBytes = 1 << 15,
+                           uint64_t readAhead = 4);
+
+    /**
+     * Write a graph to a file that can be opened as an ExternalGraph. The
+     * graph is streamed to the file twice (offsets, then heads), so it may
+     * be generated on the fly and does not need to fit into memory.
+     * @param g the graph to write
+     * @param path the file to write to (it is overwritten)
+     * @throws ExternalGraphError if the file cannot be written
+     */
+    static void write(Graph const &g, std::string const &path);
+
+    uint64_t deg(uint64_t u) const override;
+
+    uint64_t head(uint64_t u, uint64_t k) const override;
+
+    uint64_t getOrder() const override { return n; }
+
+    /**
+     * @return the number of arcs (the sum of all degrees)
+     */
+    uint64_t getSize() const { return m; }
+
+    /**
+     * @return the I/O counters since the graph was opened or reset
+     */
+    ExternalGraphStats const &getStats() const { return stats; }
+
+    void resetStats() { stats = ExternalGraphStats(); }
+
+    /**
+     * @return size of the block cache in bytes
+     */
+    uint64_t byteSize() const { return cache.capacity() * sizeof(uint64_t); }
+
+ private:
+    mutable std::ifstream file;
+    uint64_t n, m, blockWords, slots, readAhead, fileWords;
+    mutable std::vector<uint64_t> cache;
+    mutable std::vector<uint64_t> tag;
+    mutable std::vector<bool> referenced;
+    mutable std::unordered_map<uint64_t, uint64_t> slotOf;
+    mutable uint64_t hand, lastBlock, lastSlot;
+    mutable uint64_t lastVertex, lastOffset;
+    mutable ExternalGraphStats stats;
+
+    /**
+     * @return the offset of the adjacency array of u (the offset of the last
+     * requested vertex is kept, since deg() and head() are usually called
+     * for the same vertex in a row)
+     */
+    uint64_t offset(uint64_t u) const;
+
+    /**
+     * @return the i-th word of the file
+     */
+    uint64_t word(uint64_t i) const;
+
+    /**
+     * Read block b and up to readAhead following blocks into the cache.
+     */
+    void fetch(uint64_t b) const;
+
+    /**
+     * @return a free cache slot (a block is evicted if necessary)
+     */
+    uint64_t evict() const;
+};
+
+class ExternalGraphError : public std::exception {
+    const char *what() const noexcept override {
+        return "ExternalGraph: the graph file could not be read or written";
+    }
+};
+}  // namespace Sealib
+#endif  // SEALIB_GRAPH_EXTERNALGRAPH_H_
@@ -2,14 +2,21 @@
 #define SEALIB_GRAPH_GRAPHREPRESENTATIONS_H_
 #include <random>
 #include "sealib/graph/compactgraph.h"
+#include "sealib/graph/undirectedgraph.h"
 /**
  * This class contains static functions to change the
  * representation of graph structures and to generate
  * random graphs.
  *
+ * The standard representation is an array A with A[0] = n, A[v] = position
+ * of the adjacency array of vertex v (1 <= v <= n, or A[v] = v if v has no
+ * neighbours), A[n+1] = m (number of adjacency entries) and the adjacency
+ * arrays in A[n+2 .. n+m+1]. Vertex names are 1-based. A CompactGraph
+ * wraps an array in this representation.
+ *
  * The following transformation variants are available:
  * graph object 	-> standard
- * standard 			-> graph object
+ * standard 			-> undirected graph object
  * standard				-> cross pointer
  * standard			 	-> begin pointer
  * cross pointer 	-> swapped cross pointer
@@ -23,16 +30,31 @@ class Graphrepresentations {
  public:
     /**
      * Copies a graph object declared in graph.h into the standard
-     * representation used for inplace DFS and BFS
-     * @param g Graph to be transformed.
+     * representation used for inplace DFS and BFS. The vertex names are
+     * shifted by one (vertex u of g is vertex u+1 of the result).
+     * @param g Graph to be transformed (with 0-based heads, i.e. not a
+     * CompactGraph, whose data already is in standard representation)
+     * @return a new array of n+m+2 words (free it with delete[])
+     */
+    static uint64_t *graphToStandard(Graph const &g);
+
+    /**
+     * Copies a graph from standard representation to an undirected graph
+     * object. The adjacency arrays must be symmetric: every entry v in the
+     * array of u has a matching entry u in the array of v.
+     * EFFICIENCY: O(m log m) time
+     * @param g graph in standard representation
+     * @return the undirected graph with 0-based vertex names
+     * @throws std::invalid_argument if the adjacency arrays are not symmetric
      */
-    //  static uint64_t* graphToStandard(Graph* g);
+    static UndirectedGraph standardToUndirected(uint64_t const *g);
+
     /**
-     * Copies a graph from standard representation to a graph object
-     * declared in graph.h
+     * Transforms a graph inplace from standard to swapped beginpointer
+     * representation, the input of DFS::runLinearTimeInplaceDFS.
      * @param g graph in standard representation
      */
-    // static Graph* standardToGraph(uint64_t* g);
+    static void standardToSwappedBeginpointer(uint64_t *g);
     /**
      * Transforms a graph inplace from standard to crosspointer representation
      * @param g graph in standard representation
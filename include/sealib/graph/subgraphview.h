@@ -0,0 +1,57 @@
+#ifndef SEALIB_GRAPH_SUBGRAPHVIEW_H_
+#define SEALIB_GRAPH_SUBGRAPHVIEW_H_
+
+#include "sealib/collection/subgraphstack.h"
+#include "sealib/graph/undirectedgraph.h"
+
+namespace Sealib {
+
+/**
+ * A graph G_i of a subgraph stack, seen as an undirected graph with the
+ * usual 0-based names: vertex u of the view is vertex u+1 of G_i, and its
+ * k-th edge is the (k+1)-th arc of u+1 in G_i. Nothing is copied, every call
+ * is answered by the stack, so the algorithms of the library (DFS, BFS, ...)
+ * can run directly on a subgraph.
+ * The view is only valid as long as G_i is on the stack.
+ * The view has no adjacency lists of its own: getNode() and addNode() of
+ * UndirectedGraph must not be used on it, only deg(), head(), mate() and
+ * getOrder().
+ *
+ * EFFICIENCY: O(1) words, deg(), head() and mate() take the time of the
+ * corresponding stack operations
+ */
+class SubGraphView : public UndirectedGraph {
+ public:
+    /**
+     * Create a view of G_i.
+     * @param stack the subgraph stack
+     * @param i index of the graph on the stack
+     */
+    SubGraphView(SubGraphStack const &stack, uint64_t i);
+
+    /**
+     * Create a view of the graph that is currently on top of the stack.
+     * @param stack the subgraph stack
+     */
+    explicit SubGraphView(SubGraphStack const &stack);
+
+    uint64_t deg(uint64_t u) const override;
+
+    uint64_t head(uint64_t u, uint64_t k) const override;
+
+    uint64_t getOrder() const override { return n; }
+
+    uint64_t mate(uint64_t u, uint64_t k) const override;
+
+    /**
+     * @return index of the viewed graph on the stack
+     */
+    uint64_t getLevel() const { return i; }
+
+ private:
+    SubGraphStack const &stack;
+    uint64_t i, n;
+};
+
+}  // namespace Sealib
+#endif  // SEALIB_GRAPH_SUBGRAPHVIEW_H_
@@ -0,0 +1,58 @@
+#ifndef SEALIB_GRAPH_TRANSPOSEDGRAPH_H_
+#define SEALIB_GRAPH_TRANSPOSEDGRAPH_H_
+
+#include "sealib/collection/compactarray.h"
+#include "sealib/dictionary/rankselect.h"
+#include "sealib/graph/graph.h"
+
+namespace Sealib {
+
+/**
+ * A compact index of the in-arcs of a graph, usable as the transpose of the
+ * graph: head(u, k) is the k-th vertex with an arc to u. The sources of all
+ * in-arcs are kept in one compact array of m entries with ceil(log n) bits
+ * each; the start of the in-arcs of each vertex is found with a select
+ * query on a bit vector of n+m bits (a 1 per vertex, followed by a 0 per
+ * in-arc). In contrast to GraphCreator::transpose(), which builds a second
+ * adjacency list graph with a word per arc, the index needs
+ * m log n + O(n + m) bits.
+ * The in-neighbours of a vertex are ordered by their names, as in
+ * GraphCreator::transpose().
+ *
+ * EFFICIENCY: O(n+m) construction time (O(n log n) bits during
+ * construction), O(1) time for deg() and head()
+ */
+class TransposedGraph : public Graph {
+ public:
+    /**
+     * Build the in-arc index of g. Only deg() and head() of g are used.
+     * @param g the graph to transpose
+     */
+    explicit TransposedGraph(Graph const &g);
+
+    uint64_t deg(uint64_t u) const override;
+
+    uint64_t head(uint64_t u, uint64_t k) const override;
+
+    uint64_t getOrder() const override { return n; }
+
+    /**
+     * @return the size of the index in bytes
+     */
+    uint64_t byteSize() const {
+        return sources.byteSize() + offsets.byteSize();
+    }
+
+ private:
+    uint64_t n, m;
+    CompactArray sources;
+    RankSelect offsets;
+
+    /**
+     * @return the index of the first in-arc of u in sources
+     */
+    uint64_t offset(uint64_t u) const { return offsets.select(u + 1) - u - 1; }
+};
+
+}  // namespace Sealib
+#endif  // SEALIB_GRAPH_TRANSPOSEDGRAPH_H_
@@ -4,6 +4,7 @@
 #include "sealib/collection/staticspacestorage.h"
 #include "sealib/dictionary/choicedictionary.h"
 #include "sealib/dictionary/raggeddictionary.h"
+#include "sealib/dictionary/rankselect.h"
 #include "sealib/graph/undirectedgraph.h"
 
 namespace Sealib {
@@ -13,6 +14,12 @@ namespace Sealib {
  * edges can be deleted from the virtual graph. Adding new edges is only
  * supported in a rudimentary way (should be implemented in the using algorithm
  * if necessary).
+ * For each vertex, the number of present neighbours and the first and last
+ * original edge to a present neighbour are kept up to date, so the degree and
+ * the first and last edge of a vertex take constant time (in particular, both
+ * neighbours of a vertex of degree 2). Other edges are found by a scan over
+ * the original adjacency list.
+ * EFFICIENCY: O(n + m) bits
  *
  * @author Simon Heuser
  */
@@ -56,6 +63,39 @@ class VirtualGraph : UndirectedGraph {
      */
     uint64_t index(uint64_t u, uint64_t k) const;
 
+    /**
+     * Get the head of an edge given by its original index (see index()).
+     * EFFICIENCY: O(1) time for an edge of the original graph, O(log(log(n)))
+     * time for a virtual edge
+     * @param u vertex
+     * @param i original index of an edge of u: the edges of the original graph
+     * keep their index, the virtual edges have the indices g.deg(u) and
+     * g.deg(u)+1
+     * @return neighbour of u
+     */
+    uint64_t originalHead(uint64_t u, uint64_t i) const;
+
+    /**
+     * Get the original index of an edge at its other endpoint.
+     * EFFICIENCY: O(1) time for an edge of the original graph, O(log(log(n)))
+     * time for a virtual edge
+     * @param u vertex
+     * @param i original index of an edge of u (see originalHead())
+     * @return original index i' of the edge leading back to u
+     */
+    uint64_t originalMate(uint64_t u, uint64_t i) const;
+
+    /**
+     * Find the edge that leads from u to v. Virtual edges are checked first.
+     * EFFICIENCY: O(deg(u)) time, where deg(u) is the degree in the original
+     * graph
+     * @param u vertex
+     * @param v neighbour of u
+     * @return the original index i of the edge (see originalHead()), INVALID
+     * if there is none
+     */
+    uint64_t indexOf(uint64_t u, uint64_t v) const;
+
     /**
      * @return Returns the order of the graph, i.e, the total number of
      * vertices.
@@ -76,7 +116,8 @@ class VirtualGraph : UndirectedGraph {
     bool hasVertex(uint64_t u) const;
 
     /**
-     * Remove the given vertex from the virtual graph.
+     * Remove the given vertex and its virtual edges from the virtual graph.
+     * EFFICIENCY: O(deg(u)) time (amortized over all removals)
      * @param u vertex to be removed
      */
     void removeVertex(uint64_t u);
@@ -86,6 +127,9 @@ class VirtualGraph : UndirectedGraph {
      * (Note: Only up to O(n/log(n)) virtual edges may be present at any time.)
      * (Attention: Only add an edge for a vertex if at least 1 of its edges has
      * been removed previously.)
+     * A vertex has at most 2 virtual edges: the new edge takes a free place,
+     * otherwise it replaces the second virtual edge. Each virtual edge keeps
+     * its original index (see originalHead()) until it is removed.
      * EFFICIENCY: O(log(log(n))) time
      * @param u endpoint of the virtual edge
      * @param v endpoint of the virtual edge
@@ -101,14 +145,50 @@ class VirtualGraph : UndirectedGraph {
     void removeEdge(uint64_t u, uint64_t v);
 
     uint64_t byteSize() const {
-        return presentVertices.capacity() / 8 + virtualEdges.byteSize();
+        return presentVertices.capacity() / 8 + offsets.byteSize() +
+               fields.capacity() * sizeof(uint64_t) + virtualEdges.byteSize();
     }
 
  private:
+    enum Field { COUNT, FIRST, LAST };
+
+    /**
+     * Location of the fields of a vertex: 3 fields of the given width, starting
+     * at the given bit of the field array.
+     */
+    struct Slot {
+        uint64_t position, width;
+    };
+
     UndirectedGraph const &g;
     uint64_t n;
     std::vector<bool> presentVertices;
+    // number of present neighbours, first and last original edge to a present
+    // neighbour of each vertex u: 3 fields of log(deg(u)+1) bits, placed by a
+    // rank-select index over the bit pattern 1 0^deg(0) 1 0^deg(1) ...
+    RankSelect offsets;
+    std::vector<uint64_t> fields;
     RaggedPairDictionary virtualEdges;
+
+    Slot slot(uint64_t u) const;
+    uint64_t get(Slot const &s, Field f) const;
+    void set(Slot const &s, Field f, uint64_t v);
+
+    /**
+     * Find the k-th edge of u to a present neighbour, k < get(s, COUNT).
+     * @return index of the edge in the original adjacency list of u
+     */
+    uint64_t find(uint64_t u, Slot const &s, uint64_t k) const;
+
+    /**
+     * Find the j-th virtual edge of u.
+     * @return its place (0 or 1) in the pair of virtual edges of u, INVALID if
+     * there is none
+     */
+    uint64_t findVirtual(uint64_t u, uint64_t j) const;
+
+    void addVirtual(uint64_t u, uint64_t v);
+    void removeVirtual(uint64_t u, uint64_t v);
 };
 
 }  // namespace Sealib
@@ -5,8 +5,10 @@
 #include <utility>
 #include "sealib/_types.h"
 #include "sealib/collection/compactarray.h"
+#include "sealib/collection/staticspacestorage.h"
 #include "sealib/dictionary/choicedictionary.h"
 #include "sealib/graph/graph.h"
+#include "sealib/graph/undirectedgraph.h"
 #include "sealib/iterator/iterator.h"
 
 namespace Sealib {
@@ -81,20 +83,69 @@ class BFS : public Iterator<std::pair<uint64_t, uint64_t>> {
         return color.byteSize() + isInner.byteSize() + isOuter.byteSize();
     }
 
+    /**
+     * Run a BFS over the whole graph and store the distance of every vertex
+     * to the starting vertex of its component. The result uses
+     * ceil(log2(d+1)) bits per vertex, where d is the largest distance found.
+     * EFFICIENCY: O(n+m) time, O(n log d) bits
+     * @param g the graph to run the BFS over
+     * @return compact array of distances
+     */
+    static CompactArray distances(Graph const &g);
+
+    /**
+     * Run a BFS over the whole graph and store the BFS tree. The parent of a
+     * vertex v is stored as the index k of the arc (v,k) that leads back to
+     * the parent, so only O(log deg(v)) bits per vertex are needed. The
+     * starting vertex u of a component is marked with the value deg(u).
+     * EFFICIENCY: O(n+m) time, O(n+m) bits
+     * @param g undirected graph to run the BFS over
+     * @return storage of the parent arcs
+     */
+    static StaticSpaceStorage parents(UndirectedGraph const &g);
+
+    /**
+     * Find the length of a shortest path between two vertices with a
+     * bidirectional BFS. The smaller frontier is expanded level by level
+     * until the frontiers of s and t meet, so only the vertices within the
+     * two balls around s and t are touched.
+     * EFFICIENCY: O(n+m) time (worst case), O(n) bits
+     * @param g undirected graph to search
+     * @param s source vertex
+     * @param t target vertex
+     * @param touched if not null, receives the number of touched vertices
+     * @return the distance between s and t, or INVALID if t is not reachable
+     * from s
+     */
+    static uint64_t distance(UndirectedGraph const &g, uint64_t s, uint64_t t,
+                             uint64_t *touched = nullptr);
+
  private:
     Graph const &g;
     uint64_t n;
     CompactArray color;
-    uint64_t u, dist;
+    uint64_t u, dist, start;
     uint32_t innerGray, outerGray;
     ChoiceDictionary isInner, isOuter;
-    Consumer preprocess;
-    BiConsumer preexplore;
+    std::function<void(uint64_t)> preprocess;
+    std::function<void(uint64_t, uint64_t)> preexplore;
 
     bool hasGrayNode();
     uint64_t getGrayNode();
 };
 
+/**
+ * A range over a BFS (see iterate()) visits all components, like forEach().
+ */
+template <>
+struct IteratorCall<BFS, false> {
+    static void init(BFS *i) { i->BFS::init(); }
+    static bool more(BFS *i) { return i->BFS::more() || i->nextComponent(); }
+    static std::pair<uint64_t, uint64_t> next(BFS *i) {
+        return i->BFS::next();
+    }
+};
+
 class NoMoreGrayNodes : std::exception {
     const char *what() const noexcept {
         return "BFS: no more gray nodes found; did you forget to call "
@@ -0,0 +1,124 @@
+#ifndef SEALIB_ITERATOR_BLOCKCUTTREE_H_
+#define SEALIB_ITERATOR_BLOCKCUTTREE_H_
+#include <memory>
+#include <vector>
+#include "sealib/_types.h"
+#include "sealib/collection/compactarray.h"
+#include "sealib/dictionary/rankselect.h"
+#include "sealib/graph/undirectedgraph.h"
+#include "sealib/iterator/bcclabeler.h"
+#include "sealib/iterator/edgemarker.h"
+
+namespace Sealib {
+/**
+ * The block-cut tree of an undirected graph: a forest with a node for each
+ * block (biconnected component) and each cut vertex, where a cut vertex is
+ * adjacent to the blocks that contain it.
+ * The blocks are the nodes 0,...,b-1 (numbered as by BCCLabeler), the cut
+ * vertices are the nodes b,...,b+c-1 (in increasing order of the vertices).
+ * The tree is rooted as the DFS of the edge marker: the parent of a block is
+ * the cut vertex it hangs from, the parent of a cut vertex is the block of
+ * its parent edge.
+ *
+ * Storage: the cut vertices in a rank-select bit vector (n bits), the top
+ * vertex of each block (b log n bits), parent and depth of each node
+ * (2 (b+c) log(b+c) bits), plus the edge labels of a BCCLabeler
+ * (n log b bits) and the edge marker.
+ *
+ * Example:
+ *   BlockCutTree t(g);
+ *   if (!t.sameBlock(u, v)) {
+ *       for (uint64_t b : t.blockPath(u, v)) { ... }
+ *   }
+ *
+ * EFFICIENCY: O(n+m) construction time
+ */
+class BlockCutTree {
+ public:
+    /**
+     * Build the block-cut tree of an undirected graph G.
+     * @param g undirected graph G=(V,E)
+     */
+    explicit BlockCutTree(UndirectedGraph const &g);
+
+    /**
+     * Build the block-cut tree from a given edge marker (allows recycling).
+     * @param e shared pointer to an initialized EdgeMarker
+     */
+    explicit BlockCutTree(std::shared_ptr<EdgeMarker> e);
+
+    /**
+     * @return number of blocks (b)
+     */
+    uint64_t getBlockCount() const { return b; }
+
+    /**
+     * @return number of cut vertices (c)
+     */
+    uint64_t getCutVertexCount() const { return c; }
+
+    bool isCutVertex(uint64_t u) const { return cut.getBitset().get(u); }
+
+    /**
+     * @param u a cut vertex
+     * @return the tree node of u
+     */
+    uint64_t getNode(uint64_t u) const { return b + cut.rank(u + 1) - 1; }
+
+    /**
+     * @param x a tree node
+     * @return the parent node of x, or INVALID if x is a root
+     */
+    uint64_t getParent(uint64_t x) const;
+
+    /**
+     * @return true if u and v lie in a common block (for u = v: if u lies
+     * in any block)
+     * EFFICIENCY: O(1) time (O(deg(u)) for u = v)
+     */
+    bool sameBlock(uint64_t u, uint64_t v) const;
+
+    /**
+     * Execute f for each block that contains u (for a cut vertex, these are
+     * its neighbours in the tree).
+     * EFFICIENCY: O(deg(u)) time
+     */
+    void forEachBlock(uint64_t u, Consumer f) const;
+
+    /**
+     * @return the blocks on the tree path from u to v, starting at a block
+     * of u (empty if u and v are not connected or have no blocks)
+     * EFFICIENCY: O(deg(u) + deg(v) + path length) time
+     */
+    std::vector<uint64_t> blockPath(uint64_t u, uint64_t v) const;
+
+    /**
+     * @return the labeler that holds the block of each edge
+     */
+    BCCLabeler const &getLabeler() const { return l; }
+
+    uint64_t byteSize() const {
+        return l.byteSize() + cut.byteSize() + top.byteSize() +
+               parent.byteSize() + depth.byteSize();
+    }
+
+ private:
+    std::shared_ptr<EdgeMarker> e;
+    UndirectedGraph const &g;
+    uint64_t n;
+    BCCLabeler l;
+    uint64_t b, c;
+    RankSelect cut;
+    // top vertex of each block (the end of its first tree edge)
+    CompactArray top;
+    // parent and depth of each node (the parent value b+c means none)
+    CompactArray parent, depth;
+
+    /**
+     * @return a block that contains u (the tree node of u, if u is no cut
+     * vertex), or INVALID if u has no edges
+     */
+    uint64_t anyBlock(uint64_t u) const;
+};
+}  // namespace Sealib
+#endif  // SEALIB_ITERATOR_BLOCKCUTTREE_H_
@@ -0,0 +1,112 @@
+#ifndef SEALIB_ITERATOR_BRIDGEITERATOR_H_
+#define SEALIB_ITERATOR_BRIDGEITERATOR_H_
+#include <memory>
+#include <utility>
+#include "sealib/_types.h"
+#include "sealib/collection/compactarray.h"
+#include "sealib/graph/undirectedgraph.h"
+#include "sealib/iterator/edgemarker.h"
+#include "sealib/iterator/iterator.h"
+
+namespace Sealib {
+/**
+ * This iterator outputs the bridges of an undirected graph G, i.e., the edges
+ * that lie on no cycle. A tree edge of the edge marker's DFS is a bridge if
+ * no back edge marked it, so the bridges are found with one scan over the
+ * edge markings.
+ *
+ * EFFICIENCY: O(n+m) time, O(log n) bits (plus the edge marker)
+ */
+class BridgeIterator : public Iterator<std::pair<uint64_t, uint64_t>> {
+ public:
+    /**
+     * Create a new bridge iterator for an undirected graph G.
+     * @param g the undirected graph G=(V,E)
+     */
+    explicit BridgeIterator(UndirectedGraph const &g);
+
+    /**
+     * Create a new bridge iterator from a given edge marker (allows
+     * recycling).
+     * @param e shared pointer to an initialized EdgeMarker
+     */
+    explicit BridgeIterator(std::shared_ptr<EdgeMarker> e);
+
+    /**
+     * Restart the scan at the first vertex.
+     */
+    void init() override;
+
+    /**
+     * @return true if there are more bridges that have not been output
+     */
+    bool more() override;
+
+    /**
+     * @return the next bridge {u,v}, where u is the parent of v in the DFS
+     * tree of the edge marker
+     */
+    std::pair<uint64_t, uint64_t> next() override;
+
+    uint64_t byteSize() const { return e->byteSize(); }
+
+ private:
+    std::shared_ptr<EdgeMarker> e;
+    UndirectedGraph const &g;
+    uint64_t n;
+    // position of the scan (the next edge to check is (u,k))
+    uint64_t u = 0, k = 0;
+};
+
+/**
+ * Labels the 2-edge-connected components of an undirected graph, i.e., the
+ * connected components that remain after removing all bridges. Every vertex
+ * gets the id of its component, stored in a compact array of ceil(log(c))
+ * bits per vertex (c = number of components).
+ * Since no back edge crosses a bridge, each component is a subtree of the
+ * edge marker's DFS forest between bridges. The labels are assigned by a
+ * walk over the tree edges that finds the way back up by the edge markings
+ * (without a stack); component ids are assigned in the order of that walk.
+ *
+ * Example:
+ *   TwoEdgeConnectedComponents c(g);
+ *   if (c.getComponent(u) == c.getComponent(v)) { ... }
+ *
+ * EFFICIENCY: O(n+m) time, O(n log c) bits (plus the edge marker)
+ */
+class TwoEdgeConnectedComponents {
+ public:
+    /**
+     * Compute the 2-edge-connected components of an undirected graph G.
+     * @param g the undirected graph G=(V,E)
+     */
+    explicit TwoEdgeConnectedComponents(UndirectedGraph const &g);
+
+    /**
+     * Compute the 2-edge-connected components from a given edge marker.
+     * @param e an initialized EdgeMarker
+     */
+    explicit TwoEdgeConnectedComponents(EdgeMarker const &e);
+
+    /**
+     * @param u a vertex
+     * @return id of the component containing u (in [0,getCount()))
+     */
+    uint64_t getComponent(uint64_t u) const { return label.get(u); }
+
+    /**
+     * @return number of 2-edge-connected components
+     */
+    uint64_t getCount() const { return count; }
+
+    uint64_t byteSize() const { return label.byteSize(); }
+
+ private:
+    uint64_t count;
+    CompactArray label;
+
+    static uint64_t countComponents(EdgeMarker const &e);
+    void labelTree(EdgeMarker const &e, uint64_t root, uint64_t *id);
+};
+}  // namespace Sealib
+#endif  // SEALIB_ITERATOR_BRIDGEITERATOR_H_
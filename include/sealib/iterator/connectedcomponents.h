@@ -0,0 +1,64 @@
+#ifndef SEALIB_ITERATOR_CONNECTEDCOMPONENTS_H_
+#define SEALIB_ITERATOR_CONNECTEDCOMPONENTS_H_
+
+#include "sealib/_types.h"
+#include "sealib/collection/compactarray.h"
+#include "sealib/graph/undirectedgraph.h"
+
+namespace Sealib {
+/**
+ * Labels the connected components of an undirected graph. Every vertex gets
+ * the id of its component, stored in a compact array of ceil(log(c)) bits per
+ * vertex (c = number of components). Component ids are assigned in the order
+ * of the smallest vertex of each component, so both algorithms produce the
+ * same labelling.
+ *
+ * Example:
+ *   ConnectedComponents c = ConnectedComponents::parallel(g);
+ *   if (c.getComponent(u) == c.getComponent(v)) { ... }
+ */
+class ConnectedComponents {
+ public:
+    /**
+     * Compute the components with a concurrent union-find (Afforest):
+     * every thread hooks the edges of a range of vertices with atomic
+     * compare-and-swap operations. After sampling a few neighbours of each
+     * vertex, the edges of the largest intermediate component are skipped.
+     * The parent pointers are only needed during the computation.
+     * EFFICIENCY: O((n+m) log n) work, O(n log n) bits during the
+     * computation, O(n log c) bits afterwards
+     * @param g the input graph
+     * @param threads number of worker threads (0: hardware concurrency)
+     */
+    static ConnectedComponents parallel(UndirectedGraph const &g,
+                                        uint64_t threads = 0);
+
+    /**
+     * Compute the components with the space-efficient BFS: one pass counts
+     * the components, a second pass writes the labels.
+     * EFFICIENCY: O(n+m) time, O(n log c) bits (plus O(n) bits for the BFS)
+     * @param g the input graph
+     */
+    static ConnectedComponents sequential(UndirectedGraph const &g);
+
+    /**
+     * @param u a vertex
+     * @return id of the component containing u (in [0,getCount()))
+     */
+    uint64_t getComponent(uint64_t u) const { return label.get(u); }
+
+    /**
+     * @return number of connected components
+     */
+    uint64_t getCount() const { return count; }
+
+    uint64_t byteSize() const { return label.byteSize(); }
+
+ private:
+    uint64_t count;
+    CompactArray label;
+
+    ConnectedComponents(uint64_t n, uint64_t count);
+};
+}  // namespace Sealib
+#endif  // SEALIB_ITERATOR_CONNECTEDCOMPONENTS_H_
@@ -2,6 +2,7 @@
 #define SEALIB_ITERATOR_DFS_H_
 #include <functional>
 #include <stack>
+#include <string>
 #include <vector>
 #include "sealib/_types.h"
 #include "sealib/collection/compactarray.h"
@@ -18,6 +19,77 @@ static const uint64_t DFS_WHITE = 0, DFS_GRAY = 1, DFS_BLACK = 2,
 static Consumer DFS_NOP_PROCESS = [](uint64_t) {};
 static BiConsumer DFS_NOP_EXPLORE = [](uint64_t, uint64_t) {};
 
+/**
+ * The DFS variants that can be chosen by DFS::run, from the fastest to the
+ * most space-efficient one.
+ */
+enum class DFSVariant { standard, nplusmBit, nloglognBit, nBit };
+
+/**
+ * Statistics about the restorations of a space-efficient DFS. Pass a pointer
+ * to a DFS procedure or iterator to have it filled in. The values are
+ * accumulated, so one object can collect several runs.
+ */
+struct DFSStats {
+    uint64_t restorations = 0;            ///< number of restorations
+    uint64_t checkpointRestorations = 0;  ///< restorations from a checkpoint
+    uint64_t rescannedVertices = 0;  ///< vertices pushed again by restorations
+    uint64_t rescannedEdges = 0;     ///< edges inspected by restorations
+    uint64_t maxBigVertices = 0;     ///< peak usage of the big-vertex stack
+    double restoreSeconds = 0;       ///< time spent restoring the stack
+    double visitSeconds = 0;         ///< time spent outside of restorations
+};
+
+/**
+ * A DFS iterator whose progress can be written to a file and continued later,
+ * e.g. after a restart of a long-running traversal. The checkpoint holds the
+ * colors and the segment stack, so it needs about as much space as the
+ * iterator itself. It is written directly to the file, without any buffer.
+ *
+ * Example:
+ *   ResumableDFSIterator *d = DFS::getnloglognDFSIterator(g, 0);
+ *   ... // call d->next() a number of times
+ *   d->checkpoint("dfs.chk");
+ *   ... // after a restart:
+ *   ResumableDFSIterator *e = DFS::getnloglognDFSIterator(g, 0);
+ *   e->resume("dfs.chk");  // e continues where d stopped
+ */
+class ResumableDFSIterator : public Iterator<UserCall> {
+ public:
+    /**
+     * Write the current state of the DFS to a file. Can be called between
+     * any two calls of next().
+     * @param path the file to write to (it is overwritten)
+     * @throws CheckpointIOError if the file cannot be written
+     */
+    virtual void checkpoint(std::string const &path) const = 0;
+
+    /**
+     * Load a state that was written by checkpoint(). The iterator must have
+     * been created by the same factory for the same graph. The next call of
+     * next() returns the call that would have followed the checkpoint. If an
+     * exception is thrown, the iterator must not be used any more.
+     * @param path the file to read from
+     * @throws CheckpointIOError if the file cannot be read
+     * @throws CheckpointMismatch if the checkpoint belongs to another graph or
+     * DFS variant
+     */
+    virtual void resume(std::string const &path) = 0;
+};
+
+class CheckpointIOError : public std::exception {
+    const char *what() const noexcept override {
+        return "DFS checkpoint: the file could not be read or written";
+    }
+};
+
+class CheckpointMismatch : public std::exception {
+    const char *what() const noexcept override {
+        return "DFS checkpoint: the file belongs to another graph or DFS "
+               "variant";
+    }
+};
+
 /**
  * This class contains depth-first search algorithms.
  * The depth-first search of a graph processes all its nodes and explores all
@@ -38,6 +110,9 @@ static BiConsumer DFS_NOP_EXPLORE = [](uint64_t, uint64_t) {};
  *  - nplusmBitDFS: good space-efficient DFS for undirected graphs, static space
  * allocation
  *  - runLinearTimeInplaceDFS: space-efficient DFS over a compact graph
+ *
+ * If you do not want to choose a variant by hand, use run() with a memory
+ * budget.
  */
 class DFS {
  public:
@@ -80,21 +155,26 @@ class DFS {
      * @param preexplore to be executed before exploring an edge (u,k)
      * @param postexplore to be executed after exploring an edge (u,k)
      * @param postprocess to be executed after processing a node u
+     * @param stats if not null, restoration statistics are added here
      * @author Simon Heuser
      */
     static void nBitDFS(Graph const &g, Consumer preprocess = DFS_NOP_PROCESS,
                         BiConsumer preexplore = DFS_NOP_EXPLORE,
                         BiConsumer postexplore = DFS_NOP_EXPLORE,
-                        Consumer postprocess = DFS_NOP_PROCESS);
+                        Consumer postprocess = DFS_NOP_PROCESS,
+                        DFSStats *stats = nullptr);
     /**
      * Run a space-efficient depth-first search over a given graph. (Elmasry,
      * Hagerup and Kammer; 2015)
      * EFFICIENCY: O((n+m) log n) time, O((log3 + ε) n) bits
      * @param g graph G=(V,E) to iterate over
      * @param u0 start vertice
+     * @param stats if not null, restoration statistics are added here
      * @author Vytautas Hermann
      */
-    static Iterator<UserCall> *getnBitDFSIterator(Graph const &g, uint64_t u0);
+    static ResumableDFSIterator *getnBitDFSIterator(Graph const &g,
+                                                    uint64_t u0,
+                                                    DFSStats *stats = nullptr);
 
     /**
      * Run a linear-time space-efficient depth-first search. (Elmasry, Hagerup
@@ -105,23 +185,26 @@ class DFS {
      * @param preexplore to be executed before exploring an edge (u,k)
      * @param postexplore to be executed after exploring an edge (u,k)
      * @param postprocess to be executed after processing a node u
+     * @param stats if not null, restoration statistics are added here
      * @author Simon Heuser
      */
     static void nloglognBitDFS(Graph const &g,
                                Consumer preprocess = DFS_NOP_PROCESS,
                                BiConsumer preexplore = DFS_NOP_EXPLORE,
                                BiConsumer postexplore = DFS_NOP_EXPLORE,
-                               Consumer postprocess = DFS_NOP_PROCESS);
+                               Consumer postprocess = DFS_NOP_PROCESS,
+                               DFSStats *stats = nullptr);
     /**
      * Run a linear-time space-efficient depth-first search. (Elmasry, Hagerup
      * and Kammer; 2015)
      * EFFICIENCY: O(n+m) time, O(n log log n) bits
      * @param g graph G=(V,E) to iterate over
      * @param u0 start vertice
+     * @param stats if not null, restoration statistics are added here
      * @author Vytautas Hermann
      */
-    static Iterator<UserCall> *getnloglognDFSIterator(Graph const &g,
-                                                      uint64_t u0);
+    static ResumableDFSIterator *getnloglognDFSIterator(
+        Graph const &g, uint64_t u0, DFSStats *stats = nullptr);
 
     /**
      * Run a linear-time and linear-space depth-first search over an undirected
@@ -154,16 +237,104 @@ class DFS {
 
     /**
      * Runs an inplace DFS in linear time over a graph that is given in a
-     * special representation. <br>
+     * special representation. The array is validated once before the
+     * traversal and restored afterwards (the order of the entries in an
+     * adjacency array may change). Use
+     * Graphrepresentations::graphToStandard() and
+     * Graphrepresentations::standardToSwappedBeginpointer() to convert a
+     * graph object. <br>
      * EFFICIENCY: O(n+m) time, O(log n) bits
      * @param graph Graph A graph in a swapped begin pointer representation.
-     * @param startVertex startVertex The begin of the DFS tree.
+     * @param startVertex startVertex The begin of the DFS tree (1-based).
+     * @throws std::invalid_argument if the array is not in swapped begin
+     * pointer representation or the start vertex is isolated
      * @author Simon Schniedenharn
      */
     static void runLinearTimeInplaceDFS(uint64_t *graph, Consumer preProcess,
                                         Consumer postProcess,
                                         uint64_t startVertex);
 
+    /**
+     * Run the fastest depth-first search that fits into the given memory
+     * budget. The footprint of each variant is estimated from n, m and the
+     * vertex degrees (see estimateByteSize()). If only nBitDFS fits, the
+     * budget is used for its segment stack: a quarter of the largest possible
+     * segment size is used, and the remaining space keeps dropped segments as
+     * checkpoints, which keeps the number of full restorations low. If no
+     * variant fits, nBitDFS runs with the smallest possible segments.
+     * @param g graph G=(V,E) to iterate over
+     * @param memoryBudgetBytes number of bytes the DFS may use
+     * @param preprocess to be executed before processing a node u
+     * @param preexplore to be executed before exploring an edge (u,k)
+     * @param postexplore to be executed after exploring an edge (u,k)
+     * @param postprocess to be executed after processing a node u
+     * @param stats if not null, the run time (and restoration statistics of
+     * the segment-stack variants) are added here
+     * @return the variant that was run
+     */
+    static DFSVariant run(Graph const &g, uint64_t memoryBudgetBytes,
+                          Consumer preprocess = DFS_NOP_PROCESS,
+                          BiConsumer preexplore = DFS_NOP_EXPLORE,
+                          BiConsumer postexplore = DFS_NOP_EXPLORE,
+                          Consumer postprocess = DFS_NOP_PROCESS,
+                          DFSStats *stats = nullptr);
+    /**
+     * Run the fastest depth-first search over an undirected graph that fits
+     * into the given memory budget. In addition to the variants for general
+     * graphs, nplusmBitDFS is considered.
+     * @param g undirected graph G=(V,E) to iterate over
+     * @param memoryBudgetBytes number of bytes the DFS may use
+     * @param preprocess to be executed before processing a node u
+     * @param preexplore to be executed before exploring an edge (u,k)
+     * @param postexplore to be executed after exploring an edge (u,k)
+     * @param postprocess to be executed after processing a node u
+     * @param stats if not null, the run time (and restoration statistics of
+     * the segment-stack variants) are added here
+     * @return the variant that was run
+     */
+    static DFSVariant run(UndirectedGraph const &g, uint64_t memoryBudgetBytes,
+                          Consumer preprocess = DFS_NOP_PROCESS,
+                          BiConsumer preexplore = DFS_NOP_EXPLORE,
+                          BiConsumer postexplore = DFS_NOP_EXPLORE,
+                          Consumer postprocess = DFS_NOP_PROCESS,
+                          DFSStats *stats = nullptr);
+
+    /**
+     * Estimate the number of bytes a DFS variant needs for the given graph.
+     * The estimate follows the byteSize() of the structures the variant
+     * allocates. The standard DFS is estimated with a worst-case stack of n
+     * entries.
+     * @param g graph G=(V,E)
+     * @param v DFS variant
+     * @param segmentSize segment size of the nBitDFS stack (0: default
+     * segment size of nBitDFS)
+     * @param checkpoints number of checkpoint segments of the nBitDFS stack
+     * @return estimated footprint in bytes
+     */
+    static uint64_t estimateByteSize(Graph const &g, DFSVariant v,
+                                     uint64_t segmentSize = 0,
+                                     uint64_t checkpoints = 0);
+
+    /**
+     * Get the largest segment size of the nBitDFS stack that fits into the
+     * given budget.
+     * @param n number of vertices
+     * @param memoryBudgetBytes number of bytes the DFS may use
+     * @return the segment size (at least 3, at most n+1)
+     */
+    static uint64_t nBitSegmentSize(uint64_t n, uint64_t memoryBudgetBytes);
+
+    /**
+     * Get the number of checkpoint segments of the nBitDFS stack that fit
+     * into the given budget besides the low and the high segment.
+     * @param n number of vertices
+     * @param memoryBudgetBytes number of bytes the DFS may use
+     * @param segmentSize segment size of the stack
+     * @return the number of checkpoints
+     */
+    static uint64_t nBitCheckpoints(uint64_t n, uint64_t memoryBudgetBytes,
+                                    uint64_t segmentSize);
+
     /**
      * The following helper procedures are only for internal or experimental
      * usage.
@@ -189,6 +360,10 @@ class DFS {
                              BiConsumer preexplore, BiConsumer postexplore,
                              Consumer postprocess);
 
+    /**
+     * Restoration procedures. If the stack has a DFSStats object attached,
+     * the restoration is counted and timed there.
+     */
     static void restore_full(uint64_t u0, Graph const &g, CompactArray *color,
                              /*Basic*/ SegmentStack *s);
 
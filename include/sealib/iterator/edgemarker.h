@@ -44,23 +44,89 @@ class EdgeMarker {
 
     std::vector<bool> const &getCCs() const { return cc; }
 
+    /**
+     * Read-only view of the edge data of one vertex. The position of the
+     * vertex's edge records is resolved once (with a select query) when the
+     * cursor is created; afterwards, every query for an edge (u,k) is a
+     * single array access. Use a cursor when scanning the edges of a vertex.
+     * The cursor stays valid as long as the edge marker exists.
+     */
+    class Cursor {
+     public:
+        bool isInitialized(uint64_t k) const {
+            return (data(k) & TYPE_MASK) != NONE;
+        }
+        bool isTreeEdge(uint64_t k) const {
+            return (data(k) & TYPE_MASK) >= UNMARKED;
+        }
+        bool isBackEdge(uint64_t k) const {
+            return (data(k) & TYPE_MASK) == BACK;
+        }
+        /**
+         * @return true if u is closer to the root of the DFS tree
+         */
+        bool isParent(uint64_t k) const {
+            return (data(k) & PARENT_MASK) == PARENT;
+        }
+        bool isFullMarked(uint64_t k) const {
+            return (data(k) & TYPE_MASK) == FULL;
+        }
+        /**
+         * @return true if k is a tree edge that lies on no cycle (i.e., a
+         * bridge)
+         */
+        bool isUnmarked(uint64_t k) const {
+            return (data(k) & TYPE_MASK) == UNMARKED;
+        }
+
+     private:
+        friend class EdgeMarker;
+        CompactArray const *edges;
+        uint64_t begin;
+
+        Cursor(CompactArray const *e, uint64_t b) : edges(e), begin(b) {}
+        uint64_t data(uint64_t k) const { return edges->get(begin + k); }
+    };
+
+    /**
+     * @param u a vertex
+     * @return a cursor over the edge data of u
+     */
+    Cursor cursor(uint64_t u) const { return Cursor(&edges, edgeIndex(u)); }
+
+    /**
+     * Find the tree edge from u to its parent by scanning the edge data of u
+     * (the parent storage of the marker may be reused by other algorithms).
+     * @param u a vertex
+     * @return index of the edge to the parent of u, or deg(u) if u is a root
+     */
+    uint64_t parentEdge(uint64_t u) const {
+        Cursor c = cursor(u);
+        uint64_t k = 0;
+        while (k < g.deg(u) && !(c.isTreeEdge(k) && !c.isParent(k))) k++;
+        return k;
+    }
+
     bool isInitialized(uint64_t u, uint64_t k) const {
-        return (getEdgeData(u, k) & TYPE_MASK) != NONE;
+        return cursor(u).isInitialized(k);
     }
     bool isTreeEdge(uint64_t u, uint64_t k) const {
-        return (getEdgeData(u, k) & TYPE_MASK) >= UNMARKED;
+        return cursor(u).isTreeEdge(k);
     }
     bool isBackEdge(uint64_t u, uint64_t k) const {
-        return (getEdgeData(u, k) & TYPE_MASK) == BACK;
+        return cursor(u).isBackEdge(k);
     }
     /**
      * @return true if u is closer to the root of the DFS tree
      */
     bool isParent(uint64_t u, uint64_t k) const {
-        return (getEdgeData(u, k) & PARENT_MASK) == PARENT;
+        return cursor(u).isParent(k);
     }
     bool isFullMarked(uint64_t u, uint64_t k) const {
-        return (getEdgeData(u, k) & TYPE_MASK) == FULL;
+        return cursor(u).isFullMarked(k);
+    }
+    bool isUnmarked(uint64_t u, uint64_t k) const {
+        return cursor(u).isUnmarked(k);
     }
 
     uint64_t byteSize() const {
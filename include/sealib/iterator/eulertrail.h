@@ -3,26 +3,30 @@
 
 #include <sealib/dictionary/rankselect.h>
 #include <sealib/graph/undirectedgraph.h>
+#include <memory>
 #include <ostream>
-#include <vector>
 #include <tuple>
 
 namespace Sealib {
+template<class TrailStructureType>
+class TrailStorage;
+
 template<class TrailStructureType>
 /**
  * Space efficient Euler Trail class. Initialized with an undirected graph object G_0,
  * creates a set of euler partitions for G_0 during construction.
  * Uses O(n+m) time for the construction and occupies O(n) space after construction.
+ * The trail structures of all vertices are held in one TrailStorage; for
+ * TrailStructure, this is a single arena of flat arrays for the whole graph.
  * @tparam TrailStructureType
  */
 class EulerTrail {
  private:
     std::shared_ptr<Sealib::UndirectedGraph> graph;
-    std::vector<TrailStructureType>  trail;
+    std::unique_ptr<TrailStorage<TrailStructureType>> trail;
     Sealib::RankSelect trailStarts;
 
-    uint64_t findStartingNode();
-    std::vector<TrailStructureType> initializeTrail();
+    std::unique_ptr<TrailStorage<TrailStructureType>> initializeTrail();
     Sealib::Bitset<uint8_t> findTrailStarts();
 
     /**
@@ -51,6 +55,7 @@ class EulerTrail {
      * @param graph - undirected graph object for which the euler trails should be created
      */
     explicit EulerTrail(const std::shared_ptr<Sealib::UndirectedGraph> &graph);
+    ~EulerTrail();
 
     /**
      * @return iterates over all trails and writes them to the output steam
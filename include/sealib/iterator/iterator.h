@@ -1,6 +1,10 @@
 #ifndef SEALIB_ITERATOR_ITERATOR_H_
 #define SEALIB_ITERATOR_ITERATOR_H_
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace Sealib {
 /**
@@ -54,6 +58,24 @@ class Iterator {
      */
     virtual T next() = 0;
 
+    /**
+     * Get up to cap next elements at once. The elements are the same as
+     * those of repeated next() calls while more() is true; iterators that
+     * produce many small elements override this with a loop that avoids a
+     * virtual call per element.
+     * @param buf buffer for at least cap elements
+     * @param cap maximum number of elements to retrieve
+     * @return the number of elements written to buf (0 if there are no more
+     * elements)
+     */
+    virtual uint64_t nextBatch(T *buf, uint64_t cap) {
+        uint64_t c = 0;
+        while (c < cap && more()) {
+            buf[c++] = next();
+        }
+        return c;
+    }
+
  public:
     /**
      * Step through the entire range of the iterator and execute a given
@@ -75,5 +97,176 @@ class Iterator {
     Iterator &operator=(Iterator const &) = default;
     Iterator &operator=(Iterator &&) = default;
 };
+
+/**
+ * Calls the iterator methods of I without virtual dispatch (bound to the
+ * implementation in I). If I is abstract, the calls stay virtual.
+ */
+template <class I, bool = std::is_abstract<I>::value>
+struct IteratorCall {
+    static void init(I *i) { i->I::init(); }
+    static bool more(I *i) { return i->I::more(); }
+    static auto next(I *i) -> decltype(i->next()) { return i->I::next(); }
+};
+
+template <class I>
+struct IteratorCall<I, true> {
+    static void init(I *i) { i->init(); }
+    static bool more(I *i) { return i->more(); }
+    static auto next(I *i) -> decltype(i->next()) { return i->next(); }
+};
+
+/**
+ * Hands out the elements of an iterator of class I one at a time. The
+ * calls are bound statically to I (see IteratorCall).
+ */
+template <class I, bool = std::is_abstract<I>::value>
+class IteratorSource {
+ public:
+    typedef typename std::decay<decltype(std::declval<I &>().next())>::type
+        value_type;
+
+    explicit IteratorSource(I *i) : it(i) {}
+
+    void init() { IteratorCall<I>::init(it); }
+
+    /**
+     * @param v receives the next element
+     * @return false if there are no more elements
+     */
+    bool fetch(value_type *v) {
+        if (!IteratorCall<I>::more(it)) return false;
+        *v = IteratorCall<I>::next(it);
+        return true;
+    }
+
+ private:
+    I *it;
+};
+
+/**
+ * If I is abstract, the elements are retrieved with nextBatch() into a small
+ * buffer, so there is one virtual call per batch instead of two per element.
+ */
+template <class I>
+class IteratorSource<I, true> {
+ public:
+    typedef typename std::decay<decltype(std::declval<I &>().next())>::type
+        value_type;
+
+    explicit IteratorSource(I *i) : it(i), pos(0), len(0) {}
+
+    void init() {
+        it->init();
+        pos = len = 0;
+    }
+
+    bool fetch(value_type *v) {
+        if (pos == len) {
+            len = it->nextBatch(buf, BATCH);
+            pos = 0;
+            if (len == 0) return false;
+        }
+        *v = buf[pos++];
+        return true;
+    }
+
+ private:
+    static constexpr uint64_t BATCH = 64;
+    I *it;
+    value_type buf[BATCH];
+    uint64_t pos, len;
+};
+
+/**
+ * A range over the elements of an iterator of this library, for range-based
+ * for loops and STL algorithms. begin() initializes the iterator; the
+ * range can be traversed once (input iterator), and its iterators are only
+ * valid while the range exists.
+ * The iterator methods are bound statically to the class I, so the loop
+ * needs neither a virtual call nor a std::function call per element. I
+ * must therefore be the dynamic type of the iterator. If I is an abstract
+ * class (e.g. the Iterator<UserCall> of the DFS iterators), the elements are
+ * fetched in batches with nextBatch(). Use iterate() to create a range.
+ * @tparam I the iterator class
+ */
+template <class I>
+class IteratorRange {
+ public:
+    typedef typename IteratorSource<I>::value_type value_type;
+
+    class iterator {
+     public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef typename IteratorRange::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type const *pointer;
+        typedef value_type const &reference;
+
+        /** the end of every range */
+        iterator() : source(nullptr), current() {}
+
+        explicit iterator(IteratorSource<I> *s) : source(s), current() {
+            advance();
+        }
+
+        reference operator*() const { return current; }
+
+        pointer operator->() const { return &current; }
+
+        iterator &operator++() {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator r = *this;
+            advance();
+            return r;
+        }
+
+        bool operator==(iterator const &o) const { return source == o.source; }
+
+        bool operator!=(iterator const &o) const { return source != o.source; }
+
+     private:
+        IteratorSource<I> *source;
+        value_type current;
+
+        void advance() {
+            if (!source->fetch(&current)) source = nullptr;
+        }
+    };
+
+    explicit IteratorRange(I *i) : source(i) {}
+
+    iterator begin() {
+        source.init();
+        return iterator(&source);
+    }
+
+    iterator end() const { return iterator(); }
+
+ private:
+    IteratorSource<I> source;
+};
+
+/**
+ * Iterate over the elements of an iterator with a range-based for loop:
+ *   BFS bfs(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+ *   for (std::pair<uint64_t, uint64_t> p : iterate(bfs)) { ... }
+ * @param i the iterator (its static type should be its dynamic type, see
+ * IteratorRange)
+ * @return a range over the elements of i
+ */
+template <class I>
+IteratorRange<I> iterate(I &i) {
+    return IteratorRange<I>(&i);
+}
+
+template <class I>
+IteratorRange<I> iterate(I *i) {
+    return IteratorRange<I>(i);
+}
 }  // namespace Sealib
 #endif  // SEALIB_ITERATOR_ITERATOR_H_
@@ -3,6 +3,7 @@
 #include <set>
 #include <vector>
 #include "sealib/_types.h"
+#include "sealib/collection/bitset.h"
 #include "sealib/collection/compactarray.h"
 #include "sealib/dictionary/raggeddictionary.h"
 #include "sealib/dictionary/rankselect.h"
@@ -10,6 +11,22 @@
 #include "sealib/graph/virtualgraph.h"
 
 namespace Sealib {
+/**
+ * Reason why the outerplanarity check rejected a graph.
+ */
+struct OuterplanarWitness {
+    enum Type {
+        NONE,            ///< the graph is outerplanar
+        TOO_MANY_EDGES,  ///< m > 2n-3
+        SHARED_EDGE,     ///< the (possibly virtual) edge {u,v} borders three
+                         ///< faces: u and v are the poles of a K2,3 minor
+        NO_CHAIN         ///< no chain can be removed anymore: the remaining
+                         ///< graph has a K4 or K2,3 minor
+    };
+    Type type = NONE;
+    uint64_t u = INVALID, v = INVALID;
+};
+
 /**
  * Recognizes if a given biconnected graph is outerplanar.
  * (Note: You can use the BCC iterator to make a biconnected subgraph from an
@@ -33,24 +50,59 @@ class OuterplanarChecker {
      */
     bool isOuterplanar();
 
+    /**
+     * Run the check and collect a certificate for the answer in the same pass.
+     * The outer face of a biconnected outerplanar graph is a Hamiltonian
+     * cycle, and it fixes the embedding: around each vertex u, the neighbours
+     * of u appear in the order in which the cycle visits them.
+     * EFFICIENCY: O(n*log(log(n))) time, O(n) bits + O(n log(n)) bits for the
+     * outer face
+     * @param outerFace if G is outerplanar, receives the successor of each
+     * vertex on the outer face (may be nullptr)
+     * @param witness if G is not outerplanar, receives the reason (may be
+     * nullptr)
+     * @return true if G is outerplanar, false otherwise
+     */
+    bool isOuterplanar(CompactArray* outerFace, OuterplanarWitness* witness);
+
     uint64_t byteSize() const {
-        return tried.capacity() / 8 + paths.byteSize() + pathOffset.byteSize() +
-               g.byteSize();
+        return tried.byteSize() + paths.byteSize() + pathOffset.byteSize() +
+               g.byteSize() + d.byteSize() + unclosed.byteSize();
     }
 
  private:
+    UndirectedGraph const& graph;
     VirtualGraph g;
     uint64_t n, m;
     ChoiceDictionary d;
     ChoiceDictionaryIterator di;
-    std::vector<bool> tried;
+    // phase 1: vertices of degree 2 that are put off until the next round
+    Bitset<uint8_t> tried;
+    // phase 2: good chains that are not closed (one vertex each)
+    ChoiceDictionary unclosed;
+    ChoiceDictionaryIterator ui;
     CompactArray paths;
     RankSelect pathOffset;
+    OuterplanarWitness failure;
 
     bool removeClosedChains();
     bool removeAllChains();
+    bool closeLastFace();
+
+    /**
+     * Position of the path counter of the edge (u,i) in paths.
+     * @param u vertex
+     * @param i original index of the edge (see VirtualGraph::originalHead())
+     */
+    uint64_t pathIndex(uint64_t u, uint64_t i) const;
+    bool incrementPaths(uint64_t u, uint64_t i);
 
-    bool incrementPaths(uint64_t u, uint64_t k);
+    /**
+     * Number of faces that border the edge (u,k) of the original graph (1 on
+     * the outer face, 2 otherwise).
+     */
+    uint64_t faces(uint64_t u, uint64_t k) const;
+    void collectOuterFace(CompactArray* outerFace) const;
 
     /**
      * Data referring to a chain. A chain is a path where each vertex has degree
@@ -58,8 +110,10 @@ class OuterplanarChecker {
      */
     struct ChainData {
         std::pair<uint64_t, uint64_t>
-            c1,  ///< endpoint u1 + outgoing edge k1 pointing into the chain
-            c2;  ///< endpoint u2 + outgoing edge k2 pointing into the chain
+            c1,  ///< endpoint u1 + original index of the edge pointing into
+                 ///< the chain (see VirtualGraph::originalHead())
+            c2;  ///< endpoint u2 + original index of the edge pointing into
+                 ///< the chain
         bool isClosed =
                  false,      ///< true if the endpoints are connected by an edge
             isGood = false,  ///< true if one of the endpoints has degree < 4
@@ -71,13 +125,37 @@ class OuterplanarChecker {
      * Walk through the chain that contains u.
      * @param u Vertex in the interior of the chain
      * @param phase2 called from phase 2? (unlocks artificial edges)
+     * @param stopAtTried stop at the first tried vertex (phase 1; only
+     * isTried is set then)
      * @return data collected when iterating over the chain
      */
-    [[gnu::hot]] ChainData chain(uint64_t u, bool phase2 = true);
-    bool removeChain(ChainData const& c, bool phase2 = true);
+    [[gnu::hot]] ChainData chain(uint64_t u, bool phase2 = true,
+                                 bool stopAtTried = false);
+    bool removeChain(ChainData const& c);
+
+    /**
+     * Find the edge between the endpoints of a chain that is not a cycle.
+     * EFFICIENCY: O(deg) time for the endpoint of lower degree
+     * @return an endpoint and the original index of the edge to the other
+     * endpoint, or (INVALID, INVALID) if the chain is not closed
+     */
+    std::pair<uint64_t, uint64_t> closingEdge(ChainData const& c) const;
 
-    void forEdge(uint64_t v1, uint64_t v2,
-                 std::function<void(uint64_t, uint64_t)> f);
+    /**
+     * Replace a removed chain that was not closed by a virtual edge between
+     * its endpoints.
+     * @return false if an endpoint has two virtual edges already (then G is
+     * not outerplanar)
+     */
+    bool link(ChainData const& c);
+
+    /**
+     * Put off the chain that contains u until the next round of phase 1: its
+     * vertices are marked as tried and taken out of D. The walk stops at
+     * vertices that are already marked.
+     * @param u vertex of degree 2
+     */
+    void putOff(uint64_t u);
 
     [[gnu::hot]] void forEach(
         ChainData const& c, Consumer v,
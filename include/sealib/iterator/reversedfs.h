@@ -1,5 +1,7 @@
 #ifndef SEALIB_ITERATOR_REVERSEDFS_H_
 #define SEALIB_ITERATOR_REVERSEDFS_H_
+#include <deque>
+#include <future>
 #include <limits>
 #include <stack>
 #include <vector>
@@ -18,13 +20,23 @@ namespace Sealib {
  * log(n) intervals and those are simulated in reverse order.
  * As usual, call init() first, and check with more() before getting the next
  * element.
+ * The simulations of different intervals are independent once the forward
+ * run is done, so several threads can replay the upcoming intervals while
+ * the caller consumes the current one. Every thread then needs its own
+ * color array (2n bits) and buffers the user calls of one interval.
  * @author Simon Heuser
  *
  * EFFICIENCY: O(n+m) time, O(n log(log(n))) bits
  */
 class ReverseDFS : public Iterator<UserCall>, DFS {
  public:
-    explicit ReverseDFS(Graph const &);
+    /**
+     * @param g the graph to iterate over (with threads > 1, deg() and head()
+     * must be safe to call from several threads)
+     * @param threads number of intervals that are replayed in parallel (0:
+     * one per hardware thread, 1: replay sequentially)
+     */
+    explicit ReverseDFS(Graph const &g, uint64_t threads = 1);
 
     /**
      * Runs a normal DFS to record data about the intervals.
@@ -44,10 +56,19 @@ class ReverseDFS : public Iterator<UserCall>, DFS {
      */
     UserCall next() override;
 
+    /**
+     * Gets the next user calls of the reverse DFS at once (see
+     * Iterator::nextBatch()).
+     */
+    uint64_t nextBatch(UserCall *buf, uint64_t cap) override;
+
     uint64_t byteSize() const {
         return c.byteSize() + d.byteSize() + f.byteSize() + s.byteSize() +
                intervals.capacity() * sizeof(IntervalData) +
-               iWidth * sizeof(UserCall);
+               iWidth * sizeof(UserCall) +
+               (threads > 1 ? threads * (c.byteSize() +
+                                         iWidth * sizeof(UserCall))
+                            : 0);
     }
 
  private:
@@ -79,6 +100,10 @@ class ReverseDFS : public Iterator<UserCall>, DFS {
 
     std::vector<UserCall> sequence;
     std::vector<UserCall>::reverse_iterator seqI;
+    uint64_t threads;
+    // next interval to hand to a thread, and the replays in progress
+    uint64_t nextReplay = INVALID;
+    std::deque<std::future<std::vector<UserCall>>> ahead;
 
     /**
      * Inserts the missing parts (preexp/postexp) from insertNext until
@@ -91,21 +116,33 @@ class ReverseDFS : public Iterator<UserCall>, DFS {
     UserCall::Type nextType;
 
     /**
-     * Reconstruct sj from the current bottom to top entry.
+     * Reconstruct sj of interval j from its bottom to top entry.
      * @return the resulting interval stack sj
      */
-    std::stack<std::pair<uint64_t, uint64_t>> reconstructStack();
+    std::stack<std::pair<uint64_t, uint64_t>> reconstructStack(
+        uint64_t j) const;
     inline void nextInterval();
 
     /**
-     * Simulate the current interval pointed to by `i`.
+     * Simulate interval j.
+     * @param sj the stack at the start of the interval
+     * @param color colors of the vertices visited during the simulation
+     * (initially all 0)
      * @throws IntervalStackEmpty if sj is empty and no suitable first user call
      * exists to create an entry
      */
     std::vector<UserCall> simulate(
-        std::stack<std::pair<uint64_t, uint64_t>> *sj);
+        uint64_t j, std::stack<std::pair<uint64_t, uint64_t>> *sj,
+        CompactArray *color) const;
+
+    /**
+     * Replay the next interval on the worker threads and start replaying the
+     * following ones.
+     * @return the user calls of the next interval
+     */
+    std::vector<UserCall> replayAhead();
 
-    uint64_t getColor(uint64_t u);
+    uint64_t getColor(uint64_t u, uint64_t j, CompactArray const &color) const;
 };
 
 }  // namespace Sealib
@@ -1,5 +1,6 @@
 #ifndef SEALIB_ITERATOR_SCCITERATOR_H_
 #define SEALIB_ITERATOR_SCCITERATOR_H_
+#include "sealib/graph/transposedgraph.h"
 #include "sealib/iterator/reversedfs.h"
 
 namespace Sealib {
@@ -7,6 +8,9 @@ namespace Sealib {
  * Iterator over the strongly connected components of a directed graph.
  * After calling init(), use more() and next() to run DFS procedures over the
  * SCCs of the input graph.
+ * The second pass runs on a compact in-arc index of the input graph (see
+ * TransposedGraph), so the transposed graph is never built as an adjacency
+ * list graph.
  * @author Simon Heuser
  *
  * EFFICIENCY: O(n+m) time, O(n log(log(n))) bits
@@ -52,10 +56,18 @@ class SCCIterator : public Iterator<uint64_t> {
      */
     uint64_t next() override;
 
+    /**
+     * @return the size of the iterator's data structures in bytes (including
+     * the in-arc index, but not the input graph)
+     */
+    uint64_t byteSize() const {
+        return t.byteSize() + d.byteSize() + c.byteSize() + s.byteSize();
+    }
+
  private:
     DirectedGraph const &g;
     uint64_t n, u0;
-    DirectedGraph t;
+    TransposedGraph t;
     ReverseDFS d;
     CompactArray c;
     ExtendedSegmentStack s;
@@ -0,0 +1,77 @@
+#ifndef SEALIB_ITERATOR_TOPOLOGICALORDER_H_
+#define SEALIB_ITERATOR_TOPOLOGICALORDER_H_
+#include <utility>
+#include "sealib/_types.h"
+#include "sealib/collection/bitset.h"
+#include "sealib/iterator/iterator.h"
+#include "sealib/iterator/reversedfs.h"
+
+namespace Sealib {
+/**
+ * Iterator over the vertices of a directed acyclic graph in topological
+ * order: for every arc (u,v), u is returned before v.
+ * The vertices are streamed in reverse DFS postorder (the postprocess calls
+ * of a reverse DFS), so the order is never stored. An arc (u,v) with v
+ * returned before u is a back arc of the DFS and closes a cycle; every arc
+ * is checked when its tail is about to be returned, so a cycle is detected
+ * before the first vertex that would violate the order is returned.
+ * As usual, call init() first, and check with more() before getting the next
+ * element. If the graph has a cycle, more() returns false as soon as a back
+ * arc is found, and hasCycle() tells the two cases apart.
+ *
+ * Example:
+ *   TopologicalOrder t(g);
+ *   t.init();
+ *   while (t.more()) schedule(t.next());
+ *   if (t.hasCycle()) { ... }
+ *
+ * EFFICIENCY: O(n+m) time, O(n log(log(n))) bits
+ */
+class TopologicalOrder : public Iterator<uint64_t> {
+ public:
+    /**
+     * @param g the directed graph to sort
+     */
+    explicit TopologicalOrder(Graph const &g);
+
+    /**
+     * Runs the forward DFS.
+     * EFFICIENCY: O(n+m) time, O(n log(log(n))) bits
+     */
+    void init() override;
+
+    /**
+     * @return true if there is another vertex in the order (false after all
+     * vertices were returned or a cycle was found)
+     */
+    bool more() override;
+
+    /**
+     * @return the next vertex in topological order
+     */
+    uint64_t next() override;
+
+    /**
+     * @return true if the iteration stopped at a cycle
+     */
+    bool hasCycle() const { return backArc.first != INVALID; }
+
+    /**
+     * @return an arc (u,v) that closes a cycle (v reaches u), or
+     * (INVALID,INVALID) if no cycle was found (yet)
+     */
+    std::pair<uint64_t, uint64_t> getBackArc() const { return backArc; }
+
+    uint64_t byteSize() const { return d.byteSize() + returned.byteSize(); }
+
+ private:
+    Graph const &g;
+    ReverseDFS d;
+    Bitset<uint8_t> returned;
+    uint64_t u0 = INVALID;
+    std::pair<uint64_t, uint64_t> backArc{INVALID, INVALID};
+
+    uint64_t nextFinished();
+};
+}  // namespace Sealib
+#endif  // SEALIB_ITERATOR_TOPOLOGICALORDER_H_
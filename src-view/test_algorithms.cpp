@@ -14,7 +14,9 @@
 #endif
 #include "./test_algorithms.h"
 
+#include <chrono>
 #include <cstdio>
+#include <memory>
 #include <random>
 #include <sstream>
 #include <string>
@@ -23,18 +25,26 @@
 #include "../src/collection/simplesequence.h"
 #include "../src/dfs/simplereversedfs.h"
 #include "../src/graph/simplevirtualgraph.h"
+#include "../src/marker/simplebridgeiterator.h"
 #include "../src/marker/simplecutvertexiterator.h"
 #include "../src/planar/simpleouterplanarchecker.h"
 #include "sealib/_types.h"
 #include "sealib/collection/blockbitset.h"
+#include "sealib/collection/subgraphstack.h"
 #include "sealib/dictionary/choicedictionary.h"
+#include "sealib/graph/externalgraph.h"
 #include "sealib/graph/graphcreator.h"
 #include "sealib/graph/graphio.h"
+#include "sealib/graph/graphrepresentations.h"
 #include "sealib/iterator/bfs.h"
+#include "sealib/iterator/bridgeiterator.h"
+#include "sealib/iterator/choicedictionaryiterator.h"
+#include "sealib/iterator/connectedcomponents.h"
 #include "sealib/iterator/cutvertexiterator.h"
 #include "sealib/iterator/dfs.h"
 #include "sealib/iterator/outerplanarchecker.h"
 #include "sealib/iterator/reversedfs.h"
+#include "sealib/iterator/scciterator.h"
 #include "sealib/runtimetest.h"
 
 namespace Sealib {
@@ -211,6 +221,18 @@ void AlgorithmComparison::evalFunction(F f, G g, std::promise<double> r) {
             return b.byteSize();        \
         },                              \
         file1, file2, [](uint64_t n) { return (G); }, from, to
+#define Args_BR(G)                                           \
+    [](UndirectedGraph const& g) {                           \
+        SimpleBridgeIterator b(g);                           \
+        b.forEach([](std::pair<uint64_t, uint64_t>) {});     \
+        return b.byteSize();                                 \
+    },                                                       \
+        [](UndirectedGraph const& g) {                       \
+            BridgeIterator b(g);                             \
+            b.forEach([](std::pair<uint64_t, uint64_t>) {}); \
+            return b.byteSize();                             \
+        },                                                   \
+        file1, file2, [](uint64_t n) { return (G); }, from, to
 #define Args_RDFS(G)                    \
     [](DirectedGraph const& g) {        \
         SimpleReverseDFS b(g);          \
@@ -235,6 +257,28 @@ void AlgorithmComparison::evalFunction(F f, G g, std::promise<double> r) {
             return b.byteSize();       \
         },                             \
         file1, file2, [](uint64_t n) { return (G); }, from, to
+#define Args_CC(G)                                                       \
+    [](UndirectedGraph const& g) {                                       \
+        uint64_t n = g.getOrder(), c = 0;                                \
+        std::vector<uint64_t> label(n);                                  \
+        std::vector<uint8_t> color(n);                                   \
+        std::stack<std::pair<uint64_t, uint64_t>> s;                     \
+        for (uint64_t u = 0; u < n; u++) {                               \
+            if (color[u] == DFS_WHITE) {                                 \
+                DFS::visit_standard(                                     \
+                    u, g, &color, &s,                                    \
+                    [&label, &c](uint64_t v) { label[v] = c; },          \
+                    DFS_NOP_EXPLORE, DFS_NOP_EXPLORE, DFS_NOP_PROCESS);  \
+                c++;                                                     \
+            }                                                            \
+        }                                                                \
+        return label.capacity() * sizeof(uint64_t) +                     \
+               color.capacity() * sizeof(uint8_t);                       \
+    },                                                                   \
+        [](UndirectedGraph const& g) {                                   \
+            return ConnectedComponents::parallel(g, 1).byteSize();       \
+        },                                                               \
+        file1, file2, [](uint64_t n) { return (G); }, from, to
 #define Func_RandIndices(G)                                                \
     [](uint64_t n) {                                                       \
         auto g = (G);                                                      \
@@ -273,6 +317,26 @@ void AlgorithmComparison::evalFunction(F f, G g, std::promise<double> r) {
                  "/dev/null", "mem-vgra-eff-pAdj-" S ".csv",                  \
                  [](uint64_t n) { return (G); }, from, to);
 
+/**
+ * A random graph with outdegree k whose arcs are computed from a hash, so it
+ * can be written to disk without ever being held in memory.
+ */
+class HashedOutdegreeGraph : public Graph {
+ public:
+    HashedOutdegreeGraph(uint64_t order, uint64_t k) : n(order), d(k) {}
+    uint64_t deg(uint64_t) const override { return d; }
+    uint64_t head(uint64_t u, uint64_t k) const override {
+        uint64_t x = u * d + k + 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return (x ^ (x >> 31)) % n;
+    }
+    uint64_t getOrder() const override { return n; }
+
+ private:
+    uint64_t n, d;
+};
+
 int AlgorithmComparison::launch(std::string program, std::string file1,
                                 std::string file2, uint64_t from, uint64_t to) {
     int r = 0;
@@ -334,6 +398,255 @@ int AlgorithmComparison::launch(std::string program, std::string file1,
             // space OPG
             measureSpace(Args_OPG(GraphCreator::triangulated(n)));
             break;
+        case 'h':
+            // runtime OPG (cycle with n/4 chords)
+            measureTime(Args_OPG(GraphCreator::cycle(n, n / 4)));
+            break;
+        case 'H':
+            // space OPG (cycle with n/4 chords)
+            measureSpace(Args_OPG(GraphCreator::cycle(n, n / 4)));
+            break;
+        case 'e':
+            // runtime bridges
+            measureTime(Args_BR(GraphCreator::sparseUndirected(n)));
+            break;
+        case 'E':
+            // space bridges
+            measureSpace(Args_BR(GraphCreator::sparseUndirected(n)));
+            break;
+        case 'k':
+            // runtime CC (measured single-threaded: only the calling thread's
+            // time is counted)
+            measureTime(Args_CC(GraphCreator::sparseUndirected(n)));
+            break;
+        case 'K':
+            // space CC
+            measureSpace(Args_CC(GraphCreator::sparseUndirected(n)));
+            break;
+        case 'x': {
+            // semi-external DFS: runtime (file1) and bytes read per arc
+            // (file2); let 'to' exceed the available RAM
+            RuntimeTest t1, t2;
+            uint64_t step = from;
+            for (uint64_t n = from; n <= to; n += step) {
+                if (n >= 10 * step) step *= 10;
+                ExternalGraph::write(HashedOutdegreeGraph(n, 20),
+                                     "external-graph.tmp");
+                ExternalGraph g("external-graph.tmp", 1 << 26);
+                t1.runTest([&g]() { DFS::nloglognBitDFS(g); }, n,
+                           g.getSize());
+                t2.addLine(n, g.getSize(),
+                           static_cast<double>(g.getStats().bytesRead) /
+                               static_cast<double>(g.getSize()));
+                t1.saveCSV(file1);
+                t2.saveCSV(file2, "order,size,bytes per arc");
+            }
+            std::remove("external-graph.tmp");
+            t1.printResults();
+            printf("-----\n");
+            t2.printResults();
+            break;
+        }
+        case 'i': {
+            // runtime inplace DFS (file1) and n+m bit DFS (file2) on the
+            // same graph (the conversion is not measured)
+            RuntimeTest t1, t2;
+            uint64_t step = from;
+            for (uint64_t n = from; n <= to; n += step) {
+                if (n >= 10 * step) step *= 10;
+                UndirectedGraph g = GraphCreator::cycle(n, n / 4);
+                std::unique_ptr<uint64_t[]> a(
+                    Graphrepresentations::graphToStandard(g));
+                Graphrepresentations::standardToSwappedBeginpointer(a.get());
+                uint64_t m = a[n + 1];
+                for (uint64_t run = 0; run < 5; run++) {
+                    t1.runTest(
+                        [&a]() {
+                            DFS::runLinearTimeInplaceDFS(
+                                a.get(), DFS_NOP_PROCESS, DFS_NOP_PROCESS, 1);
+                        },
+                        n, m);
+                    t2.runTest([&g]() { DFS::nplusmBitDFS(g); }, n, m);
+                }
+                t1.saveCSV(file1);
+                t2.saveCSV(file2);
+            }
+            t1.printResults();
+            printf("-----\n");
+            t2.printResults();
+            break;
+        }
+        case 'p': {
+            // wall-clock time of the reverse DFS replay, sequential (file1)
+            // and with one thread per core (file2)
+            RuntimeTest t1, t2;
+            uint64_t step = from;
+            for (uint64_t n = from; n <= to; n += step) {
+                if (n >= 10 * step) step *= 10;
+                DirectedGraph g = GraphCreator::kOutdegree(n, 20);
+                for (uint64_t threads = 1; threads <= 2; threads++) {
+                    ReverseDFS r(g, threads == 1 ? 1 : 0);
+                    r.init();
+                    std::chrono::steady_clock::time_point t0 =
+                        std::chrono::steady_clock::now();
+                    std::vector<UserCall> buf(1024);
+                    while (r.nextBatch(buf.data(), buf.size()) > 0) {
+                    }
+                    double t = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - t0)
+                                   .count();
+                    (threads == 1 ? t1 : t2).addLine(n, 20 * n, t);
+                }
+                t1.saveCSV(file1);
+                t2.saveCSV(file2);
+            }
+            t1.printResults();
+            printf("-----\n");
+            t2.printResults();
+            break;
+        }
+        case 'S':
+            // SCC space: with an adjacency list transpose (file1) and with
+            // the in-arc index of the SCC iterator (file2)
+            measureSpace(
+                [](DirectedGraph const& g) {
+                    uint64_t n = g.getOrder();
+                    DirectedGraph t = GraphCreator::transpose(g);
+                    uint64_t bytes = n * sizeof(SimpleNode);
+                    for (uint64_t u = 0; u < n; u++) {
+                        bytes += t.getNode(u).getAdj().capacity() *
+                                 sizeof(uint64_t);
+                    }
+                    ReverseDFS d(g);
+                    d.init();
+                    CompactArray c(n, 3);
+                    ExtendedSegmentStack s(n, t, &c);
+                    return bytes + d.byteSize() + c.byteSize() + s.byteSize();
+                },
+                [](DirectedGraph const& g) {
+                    SCCIterator s(g);
+                    s.init();
+                    while (s.more()) s.next();
+                    return s.byteSize();
+                },
+                file1, file2,
+                [](uint64_t n) { return GraphCreator::kOutdegree(n, 20); },
+                from, to);
+            break;
+        case 'q': {
+            // subgraph stack of depth n where each level drops 1/2n of the
+            // edges: time to translate all vertices and arcs of the top graph
+            // to G_0 ten times (file1) and bytes of the stack (file2) for the
+            // tower and the geometric reference levels with base 4, 2 and 1;
+            // the second column is the base (0: the tower)
+            RuntimeTest t1, t2;
+            std::shared_ptr<UndirectedGraph> g(
+                new UndirectedGraph(GraphCreator::kRegular(10000, 8)));
+            uint64_t step = from;
+            for (uint64_t n = from; n <= to; n += step) {
+                if (n >= 10 * step) step *= 10;
+                for (uint64_t base : {0, 4, 2, 1}) {
+                    SubGraphStack s(g, base == 0
+                                           ? SubGraphStack::tetration()
+                                           : SubGraphStack::geometric(base));
+                    s.setTuningBudget(0);
+                    for (uint64_t l = 0; l < n; l++) {
+                        Bitset<uint8_t> a(s.gMax());
+                        for (uint64_t j = 0; j < a.size(); j++) a[j] = 1;
+                        for (uint64_t r = l % (2 * n) + 1; r <= a.size();
+                             r += 2 * n) {
+                            std::tuple<uint64_t, uint64_t> m =
+                                s.mate(std::get<0>(s.gInv(r)),
+                                       std::get<1>(s.gInv(r)));
+                            a[r - 1] = 0;
+                            a[s.g(std::get<0>(m), std::get<1>(m)) - 1] = 0;
+                        }
+                        s.push(std::move(a));
+                    }
+                    t1.runTest(
+                        [&s]() {
+                            for (uint64_t k = 0; k < 10; k++) {
+                                for (uint64_t u = 1; u <= s.order(); u++) {
+                                    s.phi(u);
+                                }
+                                for (uint64_t a = 1; a <= s.gMax(); a++) {
+                                    s.psi(a);
+                                }
+                            }
+                        },
+                        n, base);
+                    t2.addLine(n, base, s.byteSize());
+                }
+                t1.saveCSV(file1, "depth,base,runtime");
+                t2.saveCSV(file2, "depth,base,bytes");
+            }
+            t1.printResults();
+            printf("-----\n");
+            t2.printResults();
+            break;
+        }
+        case 'a':
+            // runtime forEach (file1) vs. range-based for loop (file2)
+            switch (program[1]) {
+                case 'b':
+                    measureTime(
+                        [](Graph const& g) {
+                            BFS b(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+                            b.forEach([](std::pair<uint64_t, uint64_t>) {});
+                        },
+                        [](Graph const& g) {
+                            BFS b(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+                            for (std::pair<uint64_t, uint64_t> p : iterate(b)) {
+                                (void)p;
+                            }
+                        },
+                        file1, file2,
+                        [](uint64_t n) {
+                            return GraphCreator::kOutdegree(n, 20);
+                        },
+                        from, to);
+                    break;
+                case 'c':
+                    measureTime(
+                        [](std::shared_ptr<ChoiceDictionary> c) {
+                            ChoiceDictionaryIterator i(*c);
+                            i.forEach([](uint64_t) {});
+                        },
+                        [](std::shared_ptr<ChoiceDictionary> c) {
+                            ChoiceDictionaryIterator i(*c);
+                            for (uint64_t u : iterate(i)) (void)u;
+                        },
+                        file1, file2,
+                        [](uint64_t n) {
+                            std::shared_ptr<ChoiceDictionary> c(
+                                new ChoiceDictionary(n));
+                            for (uint64_t a = 0; a < n; a += 3) c->insert(a);
+                            return c;
+                        },
+                        from, to);
+                    break;
+                case 'd':
+                    measureTime(
+                        [](Graph const& g) {
+                            Iterator<UserCall>* d =
+                                DFS::getStandardDFSIterator(g, 0);
+                            d->forEach([](UserCall) {});
+                            free(d);
+                        },
+                        [](Graph const& g) {
+                            Iterator<UserCall>* d =
+                                DFS::getStandardDFSIterator(g, 0);
+                            for (UserCall c : iterate(d)) (void)c;
+                            free(d);
+                        },
+                        file1, file2,
+                        [](uint64_t n) {
+                            return GraphCreator::kOutdegree(n, 20);
+                        },
+                        from, to);
+                    break;
+            }
+            break;
         case '/':
             // m/n variation tests
             switch (program[1]) {
@@ -22,7 +22,10 @@ T RaggedDictionaryBase<T>::get(uint64_t i) const {
 
 template <class T>
 void RaggedDictionaryBase<T>::insert(uint64_t i, T v) {
-    if (entryCount + 1 < keys) {
+    if (present.get(i)) {
+        // update: the number of entries stays the same
+        t[i / l].insert(i, v);
+    } else if (entryCount + 1 < keys) {
         t[i / l].insert(i, v);
         present.insert(i);
         entryCount++;
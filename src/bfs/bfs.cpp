@@ -1,4 +1,5 @@
 #include "sealib/iterator/bfs.h"
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -18,6 +19,7 @@ BFS::BFS(Graph const &graph, CompactArray c, Consumer pp, BiConsumer pe)
 
 void BFS::init() {
     u = 0;
+    start = 0;
     dist = 0;
     innerGray = BFS_GRAY1;
     outerGray = BFS_GRAY2;
@@ -28,9 +30,12 @@ void BFS::init() {
 
 bool BFS::nextComponent() {
     bool found = false;
-    for (uint64_t a = u; a < n; a++) {
+    // u is the last visited vertex, which need not be the smallest one of
+    // the component: scan on from the previous start vertex instead
+    for (uint64_t a = start; a < n; a++) {
         if (color.get(a) == BFS_WHITE) {
             u = a;
+            start = a;
             found = true;
             dist = 0;
             preprocess(u);
@@ -93,4 +98,116 @@ std::pair<uint64_t, uint64_t> BFS::next() {
     return std::pair<uint64_t, uint64_t>(u, dist);
 }
 
+CompactArray BFS::distances(Graph const &g) {
+    uint64_t maxDist = 0;
+    BFS b1(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b1.forEach([&maxDist](std::pair<uint64_t, uint64_t> p) {
+        if (p.second > maxDist) maxDist = p.second;
+    });
+    CompactArray d(g.getOrder(), std::max<uint64_t>(maxDist + 1, 2));
+    BFS b2(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b2.forEach(
+        [&d](std::pair<uint64_t, uint64_t> p) { d.insert(p.first, p.second); });
+    return d;
+}
+
+StaticSpaceStorage BFS::parents(UndirectedGraph const &g) {
+    StaticSpaceStorage parent(g);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        parent.insert(u, g.deg(u));
+    }
+    // the arcs of a vertex are explored in order, directly followed by the
+    // preprocess call of a newly discovered vertex
+    uint64_t pu = INVALID, pk = 0;
+    BFS b(g,
+          [&](uint64_t v) {
+              if (pu != INVALID && g.head(pu, pk) == v) {
+                  parent.insert(v, g.mate(pu, pk));
+              }
+          },
+          [&](uint64_t u, uint64_t) {
+              if (u != pu) {
+                  pu = u;
+                  pk = 0;
+              } else {
+                  pk++;
+              }
+          });
+    b.forEach([](std::pair<uint64_t, uint64_t>) {});
+    return parent;
+}
+
+static const uint64_t BFS_FROM_S = 1, BFS_FROM_T = 2;
+
+/**
+ * Expand one complete level of a frontier.
+ * @return true if the frontier met a vertex of the other side
+ */
+static bool expandLevel(UndirectedGraph const &g, CompactArray *color,
+                        ChoiceDictionary *current, ChoiceDictionary *next,
+                        uint64_t size, uint64_t own, uint64_t *nextSize,
+                        uint64_t *touched) {
+    *nextSize = 0;
+    for (uint64_t a = 0; a < size; a++) {
+        uint64_t u = current->choice();
+        current->remove(u);
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            uint64_t v = g.head(u, k);
+            uint64_t c = color->get(v);
+            if (c == BFS_WHITE) {
+                color->insert(v, own);
+                next->insert(v);
+                (*nextSize)++;
+                (*touched)++;
+            } else if (c != own) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+uint64_t BFS::distance(UndirectedGraph const &g, uint64_t s, uint64_t t,
+                       uint64_t *touched) {
+    uint64_t n = g.getOrder(), count = 1, r = INVALID;
+    if (s == t) {
+        r = 0;
+    } else {
+        CompactArray color(n, 3);
+        ChoiceDictionary currentS(n), nextS(n), currentT(n), nextT(n);
+        uint64_t sizeS = 1, sizeT = 1, distS = 0, distT = 0, nextSize;
+        color.insert(s, BFS_FROM_S);
+        currentS.insert(s);
+        color.insert(t, BFS_FROM_T);
+        currentT.insert(t);
+        count++;
+        while (sizeS > 0 && sizeT > 0) {
+            // all vertices of the other side with a smaller distance are
+            // surrounded by vertices of their own side, so the first meeting
+            // always closes a shortest path
+            if (sizeS <= sizeT) {
+                if (expandLevel(g, &color, &currentS, &nextS, sizeS,
+                                BFS_FROM_S, &nextSize, &count)) {
+                    r = distS + distT + 1;
+                    break;
+                }
+                std::swap(currentS, nextS);
+                sizeS = nextSize;
+                distS++;
+            } else {
+                if (expandLevel(g, &color, &currentT, &nextT, sizeT,
+                                BFS_FROM_T, &nextSize, &count)) {
+                    r = distS + distT + 1;
+                    break;
+                }
+                std::swap(currentT, nextT);
+                sizeT = nextSize;
+                distT++;
+            }
+        }
+    }
+    if (touched != nullptr) *touched = count;
+    return r;
+}
+
 }  // namespace Sealib
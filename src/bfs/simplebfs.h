@@ -35,8 +35,8 @@ class SimpleBFS : public Iterator<std::pair<uint64_t, uint64_t>> {
     std::vector<uint8_t> color;
     std::queue<std::pair<uint64_t, uint64_t>> queue;
     uint64_t qmax = 0;
-    Consumer preprocess;
-    BiConsumer preexplore;
+    std::function<void(uint64_t)> preprocess;
+    std::function<void(uint64_t, uint64_t)> preexplore;
 };
 }  // namespace Sealib
 #endif  // SRC_BFS_SIMPLEBFS_H_
@@ -0,0 +1,165 @@
+#include "sealib/iterator/connectedcomponents.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "sealib/iterator/bfs.h"
+
+namespace Sealib {
+
+/** number of neighbours of each vertex that are linked before sampling */
+static const uint64_t CC_NEIGHBOR_ROUNDS = 2;
+/** number of vertices drawn to find the largest intermediate component */
+static const uint64_t CC_SAMPLES = 1024;
+
+typedef std::vector<std::atomic<uint64_t>> ParentArray;
+
+/**
+ * Hook the trees of u and v together. The root with the larger index is
+ * always hooked below the other one, so no cycles can arise.
+ */
+static void link(ParentArray *p, uint64_t u, uint64_t v) {
+    ParentArray &parent = *p;
+    uint64_t p1 = parent[u].load(), p2 = parent[v].load();
+    while (p1 != p2) {
+        uint64_t high = std::max(p1, p2), low = std::min(p1, p2);
+        uint64_t pHigh = parent[high].load();
+        if (pHigh == low) break;
+        if (pHigh == high &&
+            parent[high].compare_exchange_strong(pHigh, low)) {
+            break;
+        }
+        p1 = parent[parent[high].load()].load();
+        p2 = parent[low].load();
+    }
+}
+
+/**
+ * Make every vertex in [from,to) point directly to its root.
+ */
+static void compress(ParentArray *p, uint64_t from, uint64_t to) {
+    ParentArray &parent = *p;
+    for (uint64_t u = from; u < to; u++) {
+        uint64_t pu = parent[u].load();
+        while (parent[pu].load() != pu) pu = parent[pu].load();
+        parent[u].store(pu);
+    }
+}
+
+/**
+ * Run f(from,to) on t threads, each on an equally sized range of [0,n).
+ * A single range is processed by the calling thread.
+ */
+template <class F>
+static void runParallel(uint64_t n, uint64_t t, F f) {
+    if (t == 1) {
+        f(0, n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    uint64_t chunk = (n + t - 1) / t;
+    for (uint64_t from = 0; from < n; from += chunk) {
+        workers.emplace_back(f, from, std::min(n, from + chunk));
+    }
+    for (std::thread &w : workers) w.join();
+}
+
+/**
+ * @return the most frequent root among some random vertices
+ */
+static uint64_t largestRoot(ParentArray const &parent) {
+    uint64_t n = parent.size();
+    std::mt19937_64 rnd(n);
+    std::uniform_int_distribution<uint64_t> dist(0, n - 1);
+    std::unordered_map<uint64_t, uint64_t> frequency;
+    uint64_t best = 0, bestCount = 0;
+    for (uint64_t a = 0; a < CC_SAMPLES; a++) {
+        uint64_t r = parent[dist(rnd)].load();
+        uint64_t c = ++frequency[r];
+        if (c > bestCount) {
+            best = r;
+            bestCount = c;
+        }
+    }
+    return best;
+}
+
+ConnectedComponents::ConnectedComponents(uint64_t n, uint64_t c)
+    : count(c), label(n, std::max<uint64_t>(c, 2)) {}
+
+ConnectedComponents ConnectedComponents::parallel(UndirectedGraph const &g,
+                                                  uint64_t threads) {
+    uint64_t n = g.getOrder();
+    if (threads == 0) {
+        threads = std::max<uint64_t>(std::thread::hardware_concurrency(), 1);
+    }
+    ParentArray parent(n);
+    for (uint64_t u = 0; u < n; u++) parent[u].store(u);
+
+    for (uint64_t r = 0; r < CC_NEIGHBOR_ROUNDS; r++) {
+        runParallel(n, threads, [&parent, &g, r](uint64_t from, uint64_t to) {
+            for (uint64_t u = from; u < to; u++) {
+                if (r < g.deg(u)) link(&parent, u, g.head(u, r));
+            }
+        });
+        runParallel(n, threads, [&parent](uint64_t from, uint64_t to) {
+            compress(&parent, from, to);
+        });
+    }
+
+    uint64_t skip = n > 0 ? largestRoot(parent) : INVALID;
+    runParallel(n, threads, [&parent, &g, skip](uint64_t from, uint64_t to) {
+        for (uint64_t u = from; u < to; u++) {
+            if (parent[u].load() == skip) continue;
+            for (uint64_t k = CC_NEIGHBOR_ROUNDS; k < g.deg(u); k++) {
+                link(&parent, u, g.head(u, k));
+            }
+        }
+    });
+    runParallel(n, threads, [&parent](uint64_t from, uint64_t to) {
+        compress(&parent, from, to);
+    });
+
+    // every root is the smallest vertex of its component
+    uint64_t c = 0;
+    for (uint64_t u = 0; u < n; u++) {
+        if (parent[u].load() == u) c++;
+    }
+    ConnectedComponents r(n, c);
+    c = 0;
+    for (uint64_t u = 0; u < n; u++) {
+        uint64_t p = parent[u].load();
+        if (p == u) {
+            r.label.insert(u, c++);
+        } else {
+            r.label.insert(u, r.label.get(p));
+        }
+    }
+    return r;
+}
+
+ConnectedComponents ConnectedComponents::sequential(UndirectedGraph const &g) {
+    uint64_t n = g.getOrder();
+    if (n == 0) return ConnectedComponents(0, 0);
+    uint64_t c = 0;
+    BFS b1(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b1.init();
+    do {
+        while (b1.more()) b1.next();
+        c++;
+    } while (b1.nextComponent());
+    ConnectedComponents r(n, c);
+    c = 0;
+    BFS b2(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b2.init();
+    do {
+        while (b2.more()) r.label.insert(b2.next().first, c);
+        c++;
+    } while (b2.nextComponent());
+    return r;
+}
+
+}  // namespace Sealib
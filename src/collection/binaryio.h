@@ -0,0 +1,69 @@
+#ifndef SRC_COLLECTION_BINARYIO_H_
+#define SRC_COLLECTION_BINARYIO_H_
+
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace Sealib {
+/**
+ * Helpers to write the state of a data structure to a binary stream as raw
+ * 64-bit words (in the byte order of the machine). Writing goes directly to
+ * the stream, so no buffer of the size of the data structure is needed.
+ */
+class BinaryIO {
+ public:
+    static void writeWord(std::ostream *out, uint64_t w) {
+        out->write(reinterpret_cast<char const *>(&w), sizeof(w));
+    }
+
+    static uint64_t readWord(std::istream *in) {
+        uint64_t w = 0;
+        in->read(reinterpret_cast<char *>(&w), sizeof(w));
+        return w;
+    }
+
+    static void writeWords(std::ostream *out, uint64_t const *w,
+                           uint64_t count) {
+        out->write(reinterpret_cast<char const *>(w),
+                   static_cast<std::streamsize>(count * sizeof(uint64_t)));
+    }
+
+    static void readWords(std::istream *in, uint64_t *w, uint64_t count) {
+        in->read(reinterpret_cast<char *>(w),
+                 static_cast<std::streamsize>(count * sizeof(uint64_t)));
+    }
+
+    static void writeTuple(std::ostream *out,
+                           std::pair<uint64_t, uint64_t> t) {
+        writeWord(out, t.first);
+        writeWord(out, t.second);
+    }
+
+    static std::pair<uint64_t, uint64_t> readTuple(std::istream *in) {
+        uint64_t u = readWord(in);
+        return {u, readWord(in)};
+    }
+
+    /**
+     * Write the first `count` tuples of a vector.
+     */
+    static void writeTuples(
+        std::ostream *out,
+        std::vector<std::pair<uint64_t, uint64_t>> const &v, uint64_t count) {
+        for (uint64_t a = 0; a < count; a++) writeTuple(out, v[a]);
+    }
+
+    /**
+     * Read `count` tuples into the beginning of a vector (which must be large
+     * enough).
+     */
+    static void readTuples(std::istream *in,
+                           std::vector<std::pair<uint64_t, uint64_t>> *v,
+                           uint64_t count) {
+        for (uint64_t a = 0; a < count; a++) (*v)[a] = readTuple(in);
+    }
+};
+}  // namespace Sealib
+#endif  // SRC_COLLECTION_BINARYIO_H_
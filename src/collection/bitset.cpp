@@ -1,4 +1,6 @@
 #include <sealib/collection/bitset.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 using Sealib::Bitset;
@@ -134,6 +136,95 @@ BlockType Sealib::Bitset<BlockType, AllocatorType>::getShiftedBlock(uint64_t idx
     return static_cast<BlockType>((b1 >> bitIdx) | (b2 << (len - bitIdx)));
 }
 
+template<typename BlockType, typename AllocatorType>
+uint64_t Bitset<BlockType, AllocatorType>::word(uint64_t w) const {
+    const uint64_t perWord = 64 / bitsPerBlock;
+    uint64_t first = w * perWord;
+    uint64_t r = 0;
+    std::memcpy(&r, &mbits[first],
+                std::min(perWord, mbits.size() - first) * sizeof(BlockType));
+    return r;
+}
+
+template<typename BlockType, typename AllocatorType>
+void Bitset<BlockType, AllocatorType>::setWord(uint64_t w, uint64_t x,
+                                               uint64_t mask) {
+    const uint64_t perWord = 64 / bitsPerBlock;
+    uint64_t first = w * perWord;
+    uint64_t bytes =
+        std::min(perWord, mbits.size() - first) * sizeof(BlockType);
+    uint64_t r = word(w);
+    r = (r & ~mask) | (x & mask);
+    std::memcpy(&mbits[first], &r, bytes);
+}
+
+template<typename BlockType, typename AllocatorType>
+uint64_t Bitset<BlockType, AllocatorType>::count(uint64_t from,
+                                                 uint64_t to) const {
+    assert(to <= bits);
+    if (from >= to) {
+        return 0;
+    }
+    uint64_t firstWord = from / 64, lastWord = (to - 1) / 64;
+    uint64_t c = 0;
+    for (uint64_t w = firstWord; w <= lastWord; w++) {
+        uint64_t x = word(w);
+        if (w == firstWord) {
+            x &= ~uint64_t(0) << (from % 64);
+        }
+        if (w == lastWord && to % 64 != 0) {
+            x &= (uint64_t(1) << (to % 64)) - 1;
+        }
+        c += static_cast<uint64_t>(__builtin_popcountll(x));
+    }
+    return c;
+}
+
+template<typename BlockType, typename AllocatorType>
+uint64_t Bitset<BlockType, AllocatorType>::next(uint64_t from) const {
+    for (uint64_t w = from / 64; w * 64 < bits && from < bits; w++) {
+        uint64_t x = word(w);
+        if (w == from / 64) {
+            x &= ~uint64_t(0) << (from % 64);
+        }
+        if (x != 0) {
+            uint64_t r = w * 64 + static_cast<uint64_t>(__builtin_ctzll(x));
+            return r < bits ? r : npos;
+        }
+    }
+    return npos;
+}
+
+template<typename BlockType, typename AllocatorType>
+uint64_t Bitset<BlockType, AllocatorType>::getBits(uint64_t from,
+                                                   uint64_t len) const {
+    assert(len <= 64 && from + len <= bits);
+    if (len == 0) {
+        return 0;
+    }
+    uint64_t o = from % 64;
+    uint64_t x = word(from / 64) >> o;
+    if (o + len > 64) {
+        x |= word(from / 64 + 1) << (64 - o);
+    }
+    return len == 64 ? x : x & ((uint64_t(1) << len) - 1);
+}
+
+template<typename BlockType, typename AllocatorType>
+void Bitset<BlockType, AllocatorType>::setBits(uint64_t from, uint64_t len,
+                                               uint64_t x) {
+    assert(len <= 64 && from + len <= bits);
+    if (len == 0) {
+        return;
+    }
+    uint64_t mask = len == 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1;
+    uint64_t o = from % 64;
+    setWord(from / 64, x << o, mask << o);
+    if (o + len > 64) {
+        setWord(from / 64 + 1, x >> (64 - o), mask >> (64 - o));
+    }
+}
+
 namespace Sealib {
 
 template
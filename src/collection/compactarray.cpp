@@ -2,6 +2,7 @@
 #include <math.h>
 #include <stdexcept>
 #include "sealib/_types.h"
+#include "./binaryio.h"
 
 #define PRELUDE                                           \
     uint64_t g1 = i * valueWidth / WORD_SIZE,             \
@@ -23,10 +24,11 @@ namespace Sealib {
 static const uint64_t WORD_SIZE = 8 * sizeof(uint64_t);
 static const uint64_t ONE = 1;
 
-CompactArray::CompactArray(uint64_t size, uint64_t values)
-    : valueWidth(static_cast<uint64_t>(ceil(log2(values)))),
+CompactArray::CompactArray(uint64_t count, uint64_t values)
+    : elements(count),
+      valueWidth(static_cast<uint64_t>(ceil(log2(values)))),
       singleMask((ONE << valueWidth) - 1),
-      data(size * valueWidth / WORD_SIZE + 1) {}
+      data(count * valueWidth / WORD_SIZE + 1) {}
 
 void CompactArray::insert(uint64_t i, uint64_t v) {
     PRELUDE
@@ -52,10 +54,52 @@ uint64_t CompactArray::get(uint64_t i) const {
     END return r;
 }
 
+uint64_t CompactArray::estimateByteSize(uint64_t count, uint64_t values) {
+    uint64_t width = static_cast<uint64_t>(ceil(log2(values)));
+    return (count * width / WORD_SIZE + 1) * sizeof(uint64_t);
+}
+
 void CompactArray::reset() {
     for (uint64_t &a : data) {
         a = 0;
     }
 }
 
+void CompactArray::replaceAll(uint64_t from, uint64_t to) {
+    uint64_t i = 0;
+    if (valueWidth > 0 && WORD_SIZE % valueWidth == 0) {
+        uint64_t perWord = WORD_SIZE / valueWidth, lowBits = 0;
+        for (uint64_t a = 0; a < perWord; a++) {
+            lowBits = (lowBits << valueWidth) | ONE;
+        }
+        uint64_t fromPattern = lowBits * from, toPattern = lowBits * to;
+        uint64_t words = elements / perWord;
+        for (uint64_t w = 0; w < words; w++) {
+            // a group equals 'from' iff all of its bits are zero after the
+            // xor; fold the bits of each group into its lowest bit
+            uint64_t x = data[w] ^ fromPattern, t = x;
+            for (uint64_t b = 1; b < valueWidth; b++) t |= x >> b;
+            uint64_t mask = (~t & lowBits) * singleMask;
+            data[w] = (data[w] & ~mask) | (toPattern & mask);
+        }
+        i = words * perWord;
+    }
+    for (; i < elements; i++) {
+        if (get(i) == from) insert(i, to);
+    }
+}
+
+void CompactArray::save(std::ostream *out) const {
+    BinaryIO::writeWord(out, elements);
+    BinaryIO::writeWord(out, valueWidth);
+    BinaryIO::writeWords(out, data.data(), data.size());
+}
+
+bool CompactArray::load(std::istream *in) {
+    uint64_t count = BinaryIO::readWord(in), width = BinaryIO::readWord(in);
+    if (!*in || count != elements || width != valueWidth) return false;
+    BinaryIO::readWords(in, data.data(), data.size());
+    return static_cast<bool>(*in);
+}
+
 }  // namespace Sealib
@@ -5,6 +5,7 @@
 #include "nplusmbitdfsiterator.h"
 #include "restoredfsiterator.h"
 #include "standarddfsiterator.h"
+#include "statstimer.h"
 
 namespace Sealib {
 
@@ -95,13 +96,20 @@ void DFS::visit_nloglogn(
 void DFS::restore_full(uint64_t u0, Graph const &g, CompactArray *color,
                        SegmentStack *ps) {
     BasicSegmentStack *s = reinterpret_cast<BasicSegmentStack *>(ps);
-    s->saveTrailer();
-    s->dropAll();
-    for (uint64_t a = 0; a < g.getOrder(); a++) {
-        if (color->get(a) == DFS_GRAY) {
-            color->insert(a, DFS_WHITE);
+    DFSStats *stats = s->getStats();
+    StatsTimer timer(stats == nullptr ? nullptr : &stats->restoreSeconds);
+    if (s->restoreCheckpoint()) {
+        if (stats != nullptr) {
+            stats->restorations++;
+            stats->checkpointRestorations++;
         }
+        timer.stop();
+        return;
     }
+    uint64_t vertices = 1, edges = 0;
+    s->saveTrailer();
+    s->dropAll();
+    color->replaceAll(DFS_GRAY, DFS_WHITE);
     s->push({u0, 0});
     std::pair<uint64_t, uint64_t> x;
     while (!s->isAligned()) {
@@ -112,14 +120,27 @@ void DFS::restore_full(uint64_t u0, Graph const &g, CompactArray *color,
             s->push({u, k + 1});
             if (s->isAligned()) break;
             uint64_t v = g.head(u, k);
-            if (color->get(v) == DFS_WHITE) s->push({v, 0});
+            edges++;
+            if (color->get(v) == DFS_WHITE) {
+                s->push({v, 0});
+                vertices++;
+            }
         }
     }
+    if (stats != nullptr) {
+        stats->restorations++;
+        stats->rescannedVertices += vertices;
+        stats->rescannedEdges += edges;
+    }
+    timer.stop();
 }
 
 void DFS::restore_top(uint64_t u0, Graph const &g, CompactArray *color,
                       SegmentStack *ps) {
     ExtendedSegmentStack *s = reinterpret_cast<ExtendedSegmentStack *>(ps);
+    DFSStats *stats = s->getStats();
+    StatsTimer timer(stats == nullptr ? nullptr : &stats->restoreSeconds);
+    uint64_t vertices = 1, edges = 0;
     std::pair<uint64_t, uint64_t> x;
     uint64_t u = u0, k = 0;
     if (s->getRestoreTrailer(&x) == 1) {
@@ -133,17 +154,26 @@ void DFS::restore_top(uint64_t u0, Graph const &g, CompactArray *color,
         std::pair<bool, uint64_t> r = s->findEdge(u, k);
         uint64_t u1 = u, k1 = r.second;
         if (r.first) {
+            edges += k1 - k + 1;
             s->push(
                 {u1, k1 + 1});  // k+1 to simulate the normal stack behaviour
             u = g.head(u1, k1);
             k = s->getOutgoingEdge(u);
             color->insert(u, DFS_WHITE);
+            vertices++;
         } else {
+            edges += g.deg(u1) - k;
             s->push({u1, k1 + 1});
             // restoration loop must end now, the stack is aligned
         }
     }
     s->recolorLow(DFS_GRAY);
+    if (stats != nullptr) {
+        stats->restorations++;
+        stats->rescannedVertices += vertices;
+        stats->rescannedEdges += edges;
+    }
+    timer.stop();
 }
 
 void DFS::visit_nplusm(uint64_t u0, UndirectedGraph const &g,
@@ -215,48 +245,72 @@ Iterator<UserCall> *DFS::getStandardDFSIterator(const Sealib::Graph &g,
     return new StandardDFSIterator(g, u0);
 }
 
-void DFS::nBitDFS(Graph const &g, Consumer preprocess, BiConsumer preexplore,
-                  BiConsumer postexplore, Consumer postprocess) {
-    uint64_t n = g.getOrder();
+/**
+ * Get the segment size of the nBitDFS stack so that 2q entries take up at
+ * most (e/3)n bits.
+ */
+static uint64_t defaultSegmentSize(uint64_t n) {
     double e = 0.2;
     uint64_t q = static_cast<uint64_t>(
-        ceil(ceil(e / 6 * n) /
-             (8 * sizeof(std::pair<uint64_t, uint64_t>))));  // 2q entries
-                                                             // on S shall
-                                                             // take up at
-                                                             // most (e/3)n
-                                                             // bits
+        ceil(ceil(e / 6 * static_cast<double>(n)) /
+             (8 * sizeof(std::pair<uint64_t, uint64_t>))));
     uint64_t qs = 3;  // stable segment size (?)
     if (q < qs) q = qs;
+    return q;
+}
 
-    BasicSegmentStack s(q);
+static void runNBit(Graph const &g, uint64_t q, uint64_t checkpoints,
+                    Consumer preprocess, BiConsumer preexplore,
+                    BiConsumer postexplore, Consumer postprocess,
+                    DFSStats *stats) {
+    StatsTimer timer(stats == nullptr ? nullptr : &stats->visitSeconds,
+                     stats == nullptr ? nullptr : &stats->restoreSeconds);
+    uint64_t n = g.getOrder();
+    BasicSegmentStack s(q, checkpoints);
+    s.setStats(stats);
     CompactArray color(n, 3);
     for (uint64_t a = 0; a < n; a++) {
         if (color.get(a) == DFS_WHITE)
-            visit_nloglogn(a, g, &color, &s, restore_full, preprocess,
-                           preexplore, postexplore, postprocess);
+            DFS::visit_nloglogn(a, g, &color, &s, DFS::restore_full,
+                                preprocess, preexplore, postexplore,
+                                postprocess);
     }
+    timer.stop();
+}
+
+void DFS::nBitDFS(Graph const &g, Consumer preprocess, BiConsumer preexplore,
+                  BiConsumer postexplore, Consumer postprocess,
+                  DFSStats *stats) {
+    runNBit(g, defaultSegmentSize(g.getOrder()), 0, preprocess, preexplore,
+            postexplore, postprocess, stats);
 }
 
-Iterator<UserCall> *DFS::getnBitDFSIterator(Graph const &g, uint64_t u0) {
-    return new RestoreDFSIterator(g, u0, restore_full, true);
+ResumableDFSIterator *DFS::getnBitDFSIterator(Graph const &g, uint64_t u0,
+                                               DFSStats *stats) {
+    return new RestoreDFSIterator(g, u0, restore_full, true, stats);
 }
 
 void DFS::nloglognBitDFS(Graph const &g, Consumer preprocess,
                          BiConsumer preexplore, BiConsumer postexplore,
-                         Consumer postprocess) {
+                         Consumer postprocess, DFSStats *stats) {
+    StatsTimer timer(stats == nullptr ? nullptr : &stats->visitSeconds,
+                     stats == nullptr ? nullptr : &stats->restoreSeconds);
     uint64_t n = g.getOrder();
     CompactArray color(n, 3);
     ExtendedSegmentStack s(n, g, &color);
+    s.setStats(stats);
     for (uint64_t a = 0; a < n; a++) {
         if (color.get(a) == DFS_WHITE)
             visit_nloglogn(a, g, &color, &s, restore_top, preprocess,
                            preexplore, postexplore, postprocess);
     }
+    timer.stop();
 }
 
-Iterator<UserCall> *DFS::getnloglognDFSIterator(Graph const &g, uint64_t u0) {
-    return new RestoreDFSIterator(g, u0, restore_top, false);
+ResumableDFSIterator *DFS::getnloglognDFSIterator(Graph const &g,
+                                                  uint64_t u0,
+                                                  DFSStats *stats) {
+    return new RestoreDFSIterator(g, u0, restore_top, false, stats);
 }
 
 void DFS::nplusmBitDFS(UndirectedGraph const &g, Consumer preprocess,
@@ -284,4 +338,116 @@ void DFS::runLinearTimeInplaceDFS(uint64_t *graph, Consumer preprocess,
     ilDFSRunner->run(startVertex);
     delete ilDFSRunner;
 }
+
+static const uint64_t TUPLE_BYTES = sizeof(std::pair<uint64_t, uint64_t>);
+static const uint64_t DFS_CHECKPOINT_SPLIT = 4;
+
+uint64_t DFS::estimateByteSize(Graph const &g, DFSVariant v,
+                               uint64_t segmentSize, uint64_t checkpoints) {
+    uint64_t n = g.getOrder();
+    uint64_t colorBytes = CompactArray::estimateByteSize(n, 3);
+    uint64_t r = 0;
+    switch (v) {
+        case DFSVariant::standard:
+            r = n * sizeof(uint8_t) + (n + 1) * TUPLE_BYTES;
+            break;
+        case DFSVariant::nplusmBit: {
+            uint64_t parentBits = 0;
+            for (uint64_t u = 0; u < n; u++) {
+                parentBits += static_cast<uint64_t>(
+                    ceil(log2(static_cast<double>(g.deg(u) + 1))));
+            }
+            r = colorBytes +
+                StaticSpaceStorage::estimateByteSize(n, parentBits);
+            break;
+        }
+        case DFSVariant::nloglognBit:
+            r = colorBytes + ExtendedSegmentStack::estimateByteSize(n);
+            break;
+        case DFSVariant::nBit: {
+            uint64_t q =
+                segmentSize == 0 ? defaultSegmentSize(n) : segmentSize;
+            r = colorBytes +
+                BasicSegmentStack::estimateByteSize(q, checkpoints);
+            break;
+        }
+    }
+    return r;
+}
+
+uint64_t DFS::nBitSegmentSize(uint64_t n, uint64_t memoryBudgetBytes) {
+    uint64_t colorBytes = CompactArray::estimateByteSize(n, 3), q = 0;
+    if (memoryBudgetBytes > colorBytes) {
+        q = (memoryBudgetBytes - colorBytes) / (2 * TUPLE_BYTES);
+    }
+    // a stack of n+1 entries never needs a restoration
+    if (q > n + 1) q = n + 1;
+    if (q < 3) q = 3;
+    return q;
+}
+
+uint64_t DFS::nBitCheckpoints(uint64_t n, uint64_t memoryBudgetBytes,
+                              uint64_t segmentSize) {
+    uint64_t colorBytes = CompactArray::estimateByteSize(n, 3), c = 0;
+    uint64_t segmentBytes = segmentSize * TUPLE_BYTES;
+    if (memoryBudgetBytes > colorBytes + 2 * segmentBytes) {
+        c = (memoryBudgetBytes - colorBytes) / segmentBytes - 2;
+    }
+    // more segments than vertices are never filled
+    uint64_t maxSegments = n / segmentSize + 1;
+    if (c > maxSegments) c = maxSegments;
+    return c;
+}
+
+static DFSVariant runBudgeted(Graph const &g, UndirectedGraph const *ug,
+                              uint64_t budget, Consumer preprocess,
+                              BiConsumer preexplore, BiConsumer postexplore,
+                              Consumer postprocess, DFSStats *stats) {
+    // the segment-stack variants fill in the statistics themselves, the
+    // others only add their run time
+    StatsTimer timer(stats == nullptr ? nullptr : &stats->visitSeconds);
+    if (DFS::estimateByteSize(g, DFSVariant::standard) <= budget) {
+        DFS::standardDFS(g, preprocess, preexplore, postexplore, postprocess);
+        timer.stop();
+        return DFSVariant::standard;
+    }
+    if (ug != nullptr &&
+        DFS::estimateByteSize(g, DFSVariant::nplusmBit) <= budget) {
+        DFS::nplusmBitDFS(*ug, preprocess, preexplore, postexplore,
+                          postprocess);
+        timer.stop();
+        return DFSVariant::nplusmBit;
+    }
+    if (DFS::estimateByteSize(g, DFSVariant::nloglognBit) <= budget) {
+        DFS::nloglognBitDFS(g, preprocess, preexplore, postexplore,
+                            postprocess, stats);
+        return DFSVariant::nloglognBit;
+    }
+    // A segment that is dropped for good loses 1/(2+c) of the stack, so the
+    // budget is split into smaller segments that are kept as checkpoints.
+    uint64_t n = g.getOrder(), q = DFS::nBitSegmentSize(n, budget), c = 0;
+    if (q <= n) {
+        q = q / DFS_CHECKPOINT_SPLIT < 3 ? 3 : q / DFS_CHECKPOINT_SPLIT;
+        c = DFS::nBitCheckpoints(n, budget, q);
+    }
+    runNBit(g, q, c, preprocess, preexplore, postexplore, postprocess, stats);
+    return DFSVariant::nBit;
+}
+
+DFSVariant DFS::run(Graph const &g, uint64_t memoryBudgetBytes,
+                    Consumer preprocess, BiConsumer preexplore,
+                    BiConsumer postexplore, Consumer postprocess,
+                    DFSStats *stats) {
+    return runBudgeted(g, nullptr, memoryBudgetBytes, preprocess, preexplore,
+                       postexplore, postprocess, stats);
+}
+
+DFSVariant DFS::run(UndirectedGraph const &g, uint64_t memoryBudgetBytes,
+                    Consumer preprocess, BiConsumer preexplore,
+                    BiConsumer postexplore, Consumer postprocess,
+                    DFSStats *stats) {
+    return runBudgeted(g, &g, memoryBudgetBytes, preprocess, preexplore,
+                       postexplore, postprocess, stats);
+}
+
 }  // namespace Sealib
@@ -13,6 +13,19 @@ namespace Sealib {
 /* @author Andrej Sajenko */
 class LinearTimeInplaceDFSRunner {
  private:
+    /**
+     * The steps of the traversal. Every step ends by handing over to the
+     * next one, so the steps run in a loop instead of calling each other
+     * (which would need a stack frame per step).
+     */
+    enum Action { VISIT, NEXT_NEIGHBOR, GO_TO_PARENT, GO_TO_CHILD, DONE };
+
+    struct Step {
+        Action action;
+        uint64_t p;
+        bool ignoreCheck;
+    };
+
     uint64_t *A;
     uint64_t n;
     uint64_t N;
@@ -36,29 +49,21 @@ class LinearTimeInplaceDFSRunner {
           m_postProcess(postProcess) {}
 
     void run(const uint64_t t_startVertex) {
+        validate(t_startVertex);
         this->m_startVertex = t_startVertex;
         this->m_initialStartVertex = t_startVertex;
-        auto p = n + 2;
-        while (A[p] != t_startVertex && p <= N) {
-            p = p + 1;
-        }
+        auto p = startPosition(t_startVertex, n + 2);
         this->startPos = p;
         this->m_initialStartPos = p;
 
-        visit(p);
+        traverse(p);
 
         uint64_t current = m_startVertex;
         while (current != this->m_initialStartVertex) {
             if (isWhite(current)) {
-                p = startPos + 1;
-                while (A[p] != current && p != m_initialStartPos) {
-                    ++p;
-                    if (p > N) {
-                        p = n + 2;
-                    }
-                }
+                p = startPosition(current, startPos + 1);
                 this->startPos = p;
-                visit(p);
+                traverse(p);
             }
             ++current;
             if (current > this->n) {
@@ -70,6 +75,109 @@ class LinearTimeInplaceDFSRunner {
     }
 
  private:
+    /**
+     * Checks once that A is a graph in swapped begin pointer representation,
+     * so that the traversal can access the array without further checks:
+     * every vertex has a first entry or is isolated (A[v] = v), every
+     * adjacency array starts with the name of its vertex and every entry
+     * points at the start of an adjacency array.
+     * @throws std::invalid_argument if the array or the start vertex is
+     * malformed
+     */
+    void validate(uint64_t startVertex) const {
+        const char *error = nullptr;
+        if (n == 0 || N < n + 1) {
+            error = "the graph has no vertices or a negative size";
+        } else if (startVertex == 0 || startVertex > n) {
+            error = "the start vertex is not a vertex of the graph";
+        } else if (A[startVertex] == startVertex) {
+            error = "the start vertex has no neighbours";
+        } else if (N > n + 1 && (A[n + 2] == 0 || A[n + 2] > n)) {
+            error = "the first adjacency array does not start with a name";
+        }
+        for (uint64_t v = 1; error == nullptr && v <= n; v++) {
+            if (A[v] != v && !isEntry(A[v])) {
+                error = "a vertex does not point at an adjacency array";
+            }
+        }
+        for (uint64_t p = n + 2; error == nullptr && p <= N; p++) {
+            uint64_t x = A[p];
+            if (x == 0 || x == n + 1 || x > N) {
+                error = "an adjacency entry is out of range";
+            } else if (x <= n && !isEntry(A[x])) {
+                error = "an adjacency array belongs to an isolated vertex";
+            } else if (x > n && !isEntry(x)) {
+                error = "an adjacency entry does not point at an array";
+            }
+        }
+        if (error != nullptr) {
+            std::stringstream ostr;
+            ostr << "Invalid graph for the inplace DFS: " << error
+                 << " (n: " << n << ", N: " << N << ")";
+            throw std::invalid_argument(ostr.str());
+        }
+    }
+
+    /**
+     * @return true if x points at the start of an adjacency array, i.e. at
+     * the name of its vertex (valid before the traversal)
+     */
+    inline bool isEntry(uint64_t x) const {
+        return x > n + 1 && x <= N && A[x] != 0 && A[x] <= n;
+    }
+
+    /**
+     * Finds the start of the adjacency array of v. A[v] holds the first
+     * entry of v, which points at the array of a neighbour w; in an
+     * undirected graph, the array of w holds an entry that points back at
+     * the array of v. Only if v is not found there (a directed graph), the
+     * array is scanned cyclically from position from.
+     */
+    uint64_t startPosition(uint64_t v, uint64_t from) const {
+        uint64_t f = A[v];
+        if (isEntry(f)) {
+            uint64_t w = A[f];
+            if (isEntry(A[w]) && A[A[w]] == v) return A[w];
+            for (uint64_t q = f + 1; q <= N && A[q] > n; q++) {
+                if (isEntry(A[q]) && A[A[q]] == v) return A[q];
+            }
+        }
+        auto p = from > N ? n + 2 : from;
+        while (A[p] != v && p != m_initialStartPos) {
+            ++p;
+            if (p > N) {
+                p = n + 2;
+            }
+        }
+        return p;
+    }
+
+    /**
+     * Runs the traversal from the adjacency array at position p until it
+     * backtracks from the start vertex.
+     */
+    void traverse(uint64_t p) {
+        Step s = {VISIT, p, false};
+        while (s.action != DONE) {
+            switch (s.action) {
+                case VISIT:
+                    s = visit(s.p);
+                    break;
+                case NEXT_NEIGHBOR:
+                    s = nextNeighbor(s.p, s.ignoreCheck);
+                    break;
+                case GO_TO_PARENT:
+                    s = goToParent(s.p);
+                    break;
+                case GO_TO_CHILD:
+                    s = goToChild(s.p);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
     inline uint64_t &U(uint64_t i) {
         if (name(i) != 0) {
             return A[A[i]];
@@ -78,13 +186,7 @@ class LinearTimeInplaceDFSRunner {
     }
 
     inline uint64_t name(uint64_t i) {
-        if (i == 0 || i == this->n + 1 || i > this->N) {
-            std::stringstream ostr;
-            ostr << "Never access 0 or n + 1, i = " << i << " n: " << n
-                 << " N: " << N;
-            throw std::invalid_argument(ostr.str());
-        }
-
+        // i is never 0 or n + 1: run() validated the input before
         auto x = A[i];
 
         if (A[x] == i && x != i) {
@@ -177,7 +279,7 @@ class LinearTimeInplaceDFSRunner {
         return GRADE_AT_LEAST_TWO;
     }
 
-    void visit(uint64_t p) {
+    Step visit(uint64_t p) {
         auto v = name(p);
         if (v == 0) {
             std::stringstream ostr;
@@ -188,7 +290,7 @@ class LinearTimeInplaceDFSRunner {
         }
         this->m_preProcess(v);
 
-        nextNeighbor(p, true);
+        return {NEXT_NEIGHBOR, p, true};
     }
 
     inline void swap(uint64_t a, uint64_t b) {
@@ -198,7 +300,7 @@ class LinearTimeInplaceDFSRunner {
         R(a) = rB;
     }
 
-    void nextNeighbor(uint64_t p, bool ignoreCheck) {
+    Step nextNeighbor(uint64_t p, bool ignoreCheck) {
         // Check if we reached the next adjacency list or the end -> must
         // backtrack
 
@@ -216,10 +318,10 @@ class LinearTimeInplaceDFSRunner {
             // and we can end the algorithm.
             if (this->startPos == q) {
                 this->m_postProcess(this->m_startVertex);
-                return;
+                return {DONE, 0, false};
             }
 
-            return goToParent(q);
+            return {GO_TO_PARENT, q, false};
         } else {
             // Otherwise p points at a vertex of at least grade 2
             uint64_t p1 = 0, p2 = 0;
@@ -242,17 +344,17 @@ class LinearTimeInplaceDFSRunner {
             }
 
             if (isWhite(name(R(p)))) {
-                return goToChild(p);
+                return {GO_TO_CHILD, p, false};
             } else {
                 if (p2 == p && R(p2) < R(p1)) {
-                    return nextNeighbor(p, false);
+                    return {NEXT_NEIGHBOR, p, false};
                 }
-                return nextNeighbor(p + 1, false);
+                return {NEXT_NEIGHBOR, p + 1, false};
             }
         }
     }
 
-    void goToParent(uint64_t q) {
+    Step goToParent(uint64_t q) {
         // If q is of grade 0
         // Will never happen because we can never go into the adjacency
         // array of a node of grade 0, we only peek inside
@@ -266,7 +368,7 @@ class LinearTimeInplaceDFSRunner {
                     this->m_postProcess(p);
                     p = A[name(q)];
                 }
-                return nextNeighbor(p, false);
+                return {NEXT_NEIGHBOR, p, false};
             }
             case GRADE_AT_LEAST_TWO: {
                 this->m_postProcess(name(q));
@@ -278,7 +380,7 @@ class LinearTimeInplaceDFSRunner {
                 U(p) = q;  // Restore childs edge => Okay only if we have two
                            // vertices.
 
-                return nextNeighbor(p, false);
+                return {NEXT_NEIGHBOR, p, false};
             }
             default: {
                 std::stringstream ostr;
@@ -290,7 +392,7 @@ class LinearTimeInplaceDFSRunner {
     }
 
     // Never call this method with p pointing at a vertex of grade zero!
-    void goToChild(uint64_t p) {
+    Step goToChild(uint64_t p) {
         auto q = R(p);
 
         int grade = pointsAtNodeOfGrade(p);
@@ -302,7 +404,7 @@ class LinearTimeInplaceDFSRunner {
                 this->m_postProcess(q);
                 A[q] = p;  // Set the reverse pointer for a later restoration.
 
-                return nextNeighbor(p, false);
+                return {NEXT_NEIGHBOR, p, false};
             }
             case GRADE_ONE: {
                 auto current = p;
@@ -331,7 +433,7 @@ class LinearTimeInplaceDFSRunner {
                                 // Reset pBar to be able to discover the
                                 // next change from |u| >= 2 to |v| = 1
                                 pBar = 0;
-                                return goToParent(current);
+                                return {GO_TO_PARENT, current, false};
                             }
                             case GRADE_ONE: {
                                 if (pBar == 0) {
@@ -372,7 +474,7 @@ class LinearTimeInplaceDFSRunner {
                                 // Reset to interrupt handling a one degree
                                 // vertex chain
                                 this->pBar = 0;
-                                return visit(next);
+                                return {VISIT, next, false};
                             }
                             default: {
                                 std::stringstream ostr;
@@ -385,7 +487,7 @@ class LinearTimeInplaceDFSRunner {
                         }
                         grade = gradeAtPosition(next);
                     } else {
-                        return goToParent(current);
+                        return {GO_TO_PARENT, current, false};
                     }
 
                     // return visit(next);
@@ -398,7 +500,7 @@ class LinearTimeInplaceDFSRunner {
                 // visited.
                 U(p) = U(q);
                 U(q) = p;
-                return visit(q);
+                return {VISIT, q, false};
             }
             default: {
                 std::stringstream ostr;
@@ -428,6 +530,19 @@ class LinearTimeInplaceDFSRunner {
                 }
             }
         }
+
+        // The starts of the adjacency arrays were overwritten with pointers
+        // to themselves; write the vertex names back (the arrays are in the
+        // order of their vertices).
+        uint64_t next = 1;
+        for (uint64_t p = n + 2; p <= this->N; ++p) {
+            if (A[p] == p) {
+                while (A[next] == next) next++;
+                A[p] = next++;
+            } else if (A[p] <= n && A[A[p]] != A[p]) {
+                next = A[p] + 1;
+            }
+        }
     }
 };
 }  // namespace Sealib
@@ -1,25 +1,36 @@
 #ifndef SRC_DFS_RESTOREDFSITERATOR_H_
 #define SRC_DFS_RESTOREDFSITERATOR_H_
 
+#include <fstream>
+#include <string>
 #include "sealib/iterator/iterator.h"
+#include "../collection/binaryio.h"
+#include "./statstimer.h"
 
 namespace Sealib {
 
-class RestoreDFSIterator : public Iterator<UserCall> {
+/** first word of a checkpoint file ("SEADFS" and a format version) */
+static const uint64_t DFS_CHECKPOINT_MAGIC = 0x5345414446530001;
+
+class RestoreDFSIterator : public ResumableDFSIterator {
  public:
     explicit RestoreDFSIterator(
         Graph const &graph, uint64_t u0,
         std::function<void(uint64_t, Graph const &, CompactArray *,
                            SegmentStack *)>
             rest,
-        bool nBit)
+        bool nBit, DFSStats *dfsStats = nullptr)
         : g(graph),
           root(u0),
           state(0),
           nextposRoot(0),
+          v(0),
           restore(std::move(rest)),
           color(g.getOrder(), 3),
-          finished(false) {
+          sr(0),
+          finished(false),
+          nBitStack(nBit),
+          stats(dfsStats) {
         if (nBit) {
             uint64_t n = g.getOrder();
             uint64_t q = static_cast<uint64_t>(
@@ -31,6 +42,7 @@ class RestoreDFSIterator : public Iterator<UserCall> {
         } else {
             s = new ExtendedSegmentStack(g.getOrder(), g, &color);
         }
+        s->setStats(stats);
         s->push({u0, 0});
     }
 
@@ -39,80 +51,161 @@ class RestoreDFSIterator : public Iterator<UserCall> {
     bool more() override { return !finished; }
 
     UserCall next() override {
-        if (!s->isEmpty() || state != 0) {
-            if (state == 0) {
-                state = 1;
-                sr = s->pop(&x);
-                if (sr == DFS_DO_RESTORE) {
-                    restore(root, g, &color, s);
-                    s->pop(&x);
-                } else if (sr == DFS_NO_MORE_NODES) {
-                    state = 0;
-                    return next();
-                }
-                r.u = x.first;
-                r.k = x.second;
-                if (color.get(r.u) == DFS_WHITE) {
-                    color.insert(r.u, DFS_GRAY);
-                    r.type = UserCall::preprocess;
-                    return r;
-                }
-            }
-            if (r.k < g.deg(r.u)) {
-                if (state == 1) {
-                    state = 2;
-                    s->push({r.u, r.k + 1});
-                    v = g.head(r.u, r.k);
-                    r.type = UserCall::preexplore;
-                    return r;
-                }
-                state = 0;
-                if (color.get(v) == DFS_WHITE) {
-                    s->push({v, 0});
-                    return next();
-                } else {
-                    r.type = UserCall::postexplore;
-                    return r;
-                }
-            } else {
-                if (state == 1) {
-                    state = 2;
-                    color.insert(r.u, DFS_BLACK);
-                    r.type = UserCall::postprocess;
-                    return r;
-                }
-                if (r.u != root) {
-                    std::pair<uint64_t, uint64_t> px;
-                    sr = s->pop(&px);
+        if (stats == nullptr) return step();
+        StatsTimer timer(&stats->visitSeconds, &stats->restoreSeconds);
+        UserCall c = step();
+        timer.stop();
+        return c;
+    }
+
+    uint64_t nextBatch(UserCall *buf, uint64_t cap) override {
+        uint64_t c = 0;
+        if (stats == nullptr) {
+            while (c < cap && !finished) buf[c++] = step();
+            return c;
+        }
+        StatsTimer timer(&stats->visitSeconds, &stats->restoreSeconds);
+        while (c < cap && !finished) buf[c++] = step();
+        timer.stop();
+        return c;
+    }
+
+    void checkpoint(std::string const &path) const override {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw CheckpointIOError();
+        BinaryIO::writeWord(&out, DFS_CHECKPOINT_MAGIC);
+        BinaryIO::writeWord(&out, nBitStack ? 1 : 0);
+        BinaryIO::writeWord(&out, g.getOrder());
+        BinaryIO::writeWord(&out, edgeCount());
+        BinaryIO::writeWord(&out, root);
+        BinaryIO::writeWord(&out, state);
+        BinaryIO::writeWord(&out, nextposRoot);
+        BinaryIO::writeWord(&out, v);
+        BinaryIO::writeTuple(&out, x);
+        BinaryIO::writeWord(&out, r.type);
+        BinaryIO::writeTuple(&out, {r.u, r.k});
+        BinaryIO::writeWord(&out, sr);
+        BinaryIO::writeWord(&out, finished ? 1 : 0);
+        color.save(&out);
+        s->save(&out);
+        out.close();
+        if (!out) throw CheckpointIOError();
+    }
+
+    void resume(std::string const &path) override {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw CheckpointIOError();
+        uint64_t magic = BinaryIO::readWord(&in);
+        uint64_t variant = BinaryIO::readWord(&in);
+        uint64_t n = BinaryIO::readWord(&in), m = BinaryIO::readWord(&in);
+        if (!in) throw CheckpointIOError();
+        if (magic != DFS_CHECKPOINT_MAGIC || variant != (nBitStack ? 1 : 0) ||
+            n != g.getOrder() || m != edgeCount()) {
+            throw CheckpointMismatch();
+        }
+        root = BinaryIO::readWord(&in);
+        state = BinaryIO::readWord(&in);
+        nextposRoot = BinaryIO::readWord(&in);
+        v = BinaryIO::readWord(&in);
+        x = BinaryIO::readTuple(&in);
+        r.type = static_cast<uint8_t>(BinaryIO::readWord(&in));
+        std::pair<uint64_t, uint64_t> call = BinaryIO::readTuple(&in);
+        r.u = call.first;
+        r.k = call.second;
+        sr = static_cast<uint8_t>(BinaryIO::readWord(&in));
+        finished = BinaryIO::readWord(&in) != 0;
+        if (!color.load(&in) || !s->load(&in)) {
+            if (!in) throw CheckpointIOError();
+            throw CheckpointMismatch();
+        }
+    }
+
+ private:
+    uint64_t edgeCount() const {
+        uint64_t m = 0;
+        for (uint64_t u = 0; u < g.getOrder(); u++) m += g.deg(u);
+        return m;
+    }
+
+    UserCall step() {
+        while (true) {
+            if (!s->isEmpty() || state != 0) {
+                if (state == 0) {
+                    state = 1;
+                    sr = s->pop(&x);
                     if (sr == DFS_DO_RESTORE) {
                         restore(root, g, &color, s);
-                        s->pop(&px);
+                        s->pop(&x);
+                    } else if (sr == DFS_NO_MORE_NODES) {
+                        state = 0;
+                        continue;
+                    }
+                    r.u = x.first;
+                    r.k = x.second;
+                    if (color.get(r.u) == DFS_WHITE) {
+                        color.insert(r.u, DFS_GRAY);
+                        r.type = UserCall::preprocess;
+                        return r;
+                    }
+                }
+                if (r.k < g.deg(r.u)) {
+                    if (state == 1) {
+                        state = 2;
+                        s->push({r.u, r.k + 1});
+                        v = g.head(r.u, r.k);
+                        r.type = UserCall::preexplore;
+                        return r;
                     }
-                    s->push(px);
-                    r.type = UserCall::postexplore;
-                    r.u = px.first;
-                    r.k = px.second - 1;
                     state = 0;
-                    return r;
+                    if (color.get(v) == DFS_WHITE) {
+                        s->push({v, 0});
+                        continue;
+                    } else {
+                        r.type = UserCall::postexplore;
+                        return r;
+                    }
+                } else {
+                    if (state == 1) {
+                        state = 2;
+                        color.insert(r.u, DFS_BLACK);
+                        r.type = UserCall::postprocess;
+                        return r;
+                    }
+                    if (r.u != root) {
+                        std::pair<uint64_t, uint64_t> px;
+                        sr = s->pop(&px);
+                        if (sr == DFS_DO_RESTORE) {
+                            restore(root, g, &color, s);
+                            s->pop(&px);
+                        }
+                        s->push(px);
+                        r.type = UserCall::postexplore;
+                        r.u = px.first;
+                        r.k = px.second - 1;
+                        state = 0;
+                        return r;
+                    }
                 }
-            }
-            state = 0;
-            return next();
-        }
-        for (; nextposRoot < g.getOrder(); nextposRoot++) {
-            if (color.get(nextposRoot) == DFS_WHITE) {
-                root = nextposRoot;
-                s->push({root, 0});
                 state = 0;
-                return next();
+                continue;
             }
+            bool found = false;
+            for (; nextposRoot < g.getOrder(); nextposRoot++) {
+                if (color.get(nextposRoot) == DFS_WHITE) {
+                    root = nextposRoot;
+                    s->push({root, 0});
+                    state = 0;
+                    found = true;
+                    break;
+                }
+            }
+            if (found) continue;
+            finished = true;
+            r.type = UserCall::nop;
+            return r;
         }
-        finished = true;
-        r.type = UserCall::nop;
-        return r;
     }
 
- private:
     Graph const &g;
     uint64_t root;
     uint64_t state;
@@ -126,6 +219,8 @@ class RestoreDFSIterator : public Iterator<UserCall> {
     UserCall r;
     uint8_t sr;
     bool finished;
+    bool nBitStack;
+    DFSStats *stats;
 };
 
 }  // namespace Sealib
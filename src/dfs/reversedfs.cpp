@@ -1,10 +1,11 @@
 #include "sealib/iterator/reversedfs.h"
 #include <cmath>
 #include <set>
+#include <thread>
 
 namespace Sealib {
 
-ReverseDFS::ReverseDFS(Graph const &graph)
+ReverseDFS::ReverseDFS(Graph const &graph, uint64_t threadCount)
     : g(graph),
       n(g.getOrder()),
       iCount(static_cast<uint64_t>(4 * log2(n) / log2(log2(n))) + 1),
@@ -16,7 +17,11 @@ ReverseDFS::ReverseDFS(Graph const &graph)
       intervals(1),
       i(intervals.begin()),
       sequence(),
-      seqI(sequence.rend()) {
+      seqI(sequence.rend()),
+      threads(threadCount) {
+    if (threads == 0) {
+        threads = std::max<uint64_t>(std::thread::hardware_concurrency(), 1);
+    }
     for (uint64_t a = 0; a < n; a++) {
         d.insert(a, iCount);
     }
@@ -25,6 +30,11 @@ ReverseDFS::ReverseDFS(Graph const &graph)
 const std::pair<uint64_t, uint64_t> ReverseDFS::NIL = {INVALID, INVALID};
 
 void ReverseDFS::init() {
+    // drop replays left over from a previous run (this waits for them)
+    ahead.clear();
+    sequence.clear();
+    seqI = sequence.rend();
+    haveNext = false;
     i->firstCall = UserCall(UserCall::preprocess, 0);
     UserCall::Type trace;
     for (uint64_t u0 = 0; u0 < n; u0++) {
@@ -106,6 +116,7 @@ void ReverseDFS::init() {
         }
     }
     assert(ip < iCount);
+    nextReplay = ip;
 }
 
 void ReverseDFS::nextInterval() {
@@ -160,9 +171,14 @@ UserCall ReverseDFS::next() {
             return r;
         }
     } else {  // build new sequence
-        c.reset();
-        std::stack<std::pair<uint64_t, uint64_t>> sj = reconstructStack();
-        sequence = simulate(&sj);
+        if (threads > 1) {
+            sequence = replayAhead();
+        } else {
+            c.reset();
+            std::stack<std::pair<uint64_t, uint64_t>> sj =
+                reconstructStack(ip);
+            sequence = simulate(ip, &sj, &c);
+        }
         seqI = sequence.rbegin();
         std::advance(i, -1);
         ip--;
@@ -170,6 +186,14 @@ UserCall ReverseDFS::next() {
     }
 }
 
+uint64_t ReverseDFS::nextBatch(UserCall *buf, uint64_t cap) {
+    uint64_t a = 0;
+    while (a < cap && ReverseDFS::more()) {
+        buf[a++] = ReverseDFS::next();
+    }
+    return a;
+}
+
 UserCall ReverseDFS::insertMinor() {
     UserCall r(nextType, insertNext.first, insertNext.second);
     if (nextType == UserCall::preexplore) {
@@ -186,18 +210,34 @@ UserCall ReverseDFS::insertMinor() {
     return r;
 }
 
-std::stack<std::pair<uint64_t, uint64_t>> ReverseDFS::reconstructStack() {
+std::vector<UserCall> ReverseDFS::replayAhead() {
+    while (ahead.size() < threads && nextReplay != INVALID) {
+        uint64_t j = nextReplay--;
+        ahead.push_back(std::async(std::launch::async, [this, j]() {
+            CompactArray color(n, 3);
+            std::stack<std::pair<uint64_t, uint64_t>> sj = reconstructStack(j);
+            return simulate(j, &sj, &color);
+        }));
+    }
+    std::vector<UserCall> r = ahead.front().get();
+    ahead.pop_front();
+    return r;
+}
+
+std::stack<std::pair<uint64_t, uint64_t>> ReverseDFS::reconstructStack(
+    uint64_t j) const {
     std::stack<std::pair<uint64_t, uint64_t>> r;
+    IntervalData const &iv = intervals[j];
     std::vector<bool> used(n, 0);
-    if (i->bottom != NIL) {
+    if (iv.bottom != NIL) {
         // restore all u with d[u]<j and f[u]==j
-        std::pair<uint64_t, uint64_t> a = i->bottom;
+        std::pair<uint64_t, uint64_t> a = iv.bottom;
         r.push(a);
         used[a.first] = true;
-        while (a.first != i->top.first) {
+        while (a.first != iv.top.first) {
             for (uint64_t b = 0; b < g.deg(a.first); b++) {
                 uint64_t v = g.head(a.first, b);
-                if (d.get(v) < ip && f.get(v) == ip && !used[v]) {
+                if (d.get(v) < j && f.get(v) == j && !used[v]) {
                     used[v] = true;
                     r.top().second = b + 1;
                     a = {v, INVALID};
@@ -208,72 +248,76 @@ std::stack<std::pair<uint64_t, uint64_t>> ReverseDFS::reconstructStack() {
                    "### stack reconstruction failed ###");
             r.push(a);
         }  // loop only ends when top has been pushed
-        r.top() = i->top;
+        r.top() = iv.top;
     }
     return r;
 }
 
 std::vector<UserCall> ReverseDFS::simulate(
-    std::stack<std::pair<uint64_t, uint64_t>> *sj) {
+    uint64_t j, std::stack<std::pair<uint64_t, uint64_t>> *sj,
+    CompactArray *color) const {
     std::vector<UserCall> r;
-    if (i->firstCall.type == UserCall::preprocess) {
-        sj->push({i->firstCall.u, 0});
-    } else if (i->firstCall.type == UserCall::preexplore) {
+    IntervalData const &iv = intervals[j];
+    if (iv.firstCall.type == UserCall::preprocess) {
+        sj->push({iv.firstCall.u, 0});
+    } else if (iv.firstCall.type == UserCall::preexplore) {
         // we don't have to be careful here because u must be gray
         sj->top().second -= 1;
-    } else if (i->firstCall.type == UserCall::postprocess) {
-        if (sj->empty()) sj->push({i->firstCall.u, g.deg(i->firstCall.u)});
-    } else if (i->firstCall.type == UserCall::postexplore) {
+    } else if (iv.firstCall.type == UserCall::postprocess) {
+        if (sj->empty()) sj->push({iv.firstCall.u, g.deg(iv.firstCall.u)});
+    } else if (iv.firstCall.type == UserCall::postexplore) {
         r.emplace_back(
-            UserCall(UserCall::postexplore, i->firstCall.u, i->firstCall.k));
-        if (sj->empty()) sj->push({i->firstCall.u, i->firstCall.k + 1});
+            UserCall(UserCall::postexplore, iv.firstCall.u, iv.firstCall.k));
+        if (sj->empty()) sj->push({iv.firstCall.u, iv.firstCall.k + 1});
         // now, proceed normally
     }
 
     do {
-        while (!sj->empty() && r.size() < i->width) {
+        while (!sj->empty() && r.size() < iv.width) {
             std::pair<uint64_t, uint64_t> x = sj->top();
             sj->pop();
             uint64_t u = x.first, k = x.second;
-            if (getColor(u) == DFS_WHITE) {
+            if (getColor(u, j, *color) == DFS_WHITE) {
                 r.emplace_back(UserCall(UserCall::preprocess, u));
-                c.insert(u, DFS_GRAY);
+                color->insert(u, DFS_GRAY);
             }
-            if (k < g.deg(u) && r.size() < i->width) {
+            if (k < g.deg(u) && r.size() < iv.width) {
                 sj->push({u, k + 1});
                 uint64_t v = g.head(u, k);
-                if (getColor(v) == DFS_WHITE && r.size() < i->width) {
+                if (getColor(v, j, *color) == DFS_WHITE &&
+                    r.size() < iv.width) {
                     r.emplace_back(UserCall(UserCall::preexplore, u, k));
                     sj->push({v, 0});
                 }
-            } else if (r.size() < i->width) {
-                c.insert(u, DFS_BLACK);
+            } else if (r.size() < iv.width) {
+                color->insert(u, DFS_BLACK);
                 r.emplace_back(UserCall(UserCall::Type::postprocess, u));
-                if (!sj->empty() && r.size() < i->width) {
+                if (!sj->empty() && r.size() < iv.width) {
                     std::pair<uint64_t, uint64_t> p = sj->top();
                     r.emplace_back(UserCall(UserCall::Type::postexplore,
                                             p.first, p.second - 1));
                 }
             }
         }
-        if (sj->empty() && r.size() < i->width) {
+        if (sj->empty() && r.size() < iv.width) {
             for (uint64_t u = 0; u < n; u++) {
-                if (getColor(u) == DFS_WHITE) {
+                if (getColor(u, j, *color) == DFS_WHITE) {
                     sj->push({u, 0});
                     break;
                 }
             }
         }
-    } while (!sj->empty() && r.size() < i->width);
+    } while (!sj->empty() && r.size() < iv.width);
     return r;
 }
 
-uint64_t ReverseDFS::getColor(uint64_t u) {
-    uint64_t a = c.get(u);
+uint64_t ReverseDFS::getColor(uint64_t u, uint64_t j,
+                              CompactArray const &color) const {
+    uint64_t a = color.get(u);
     if (a == 0) {
-        if (f.get(u) < ip) {
+        if (f.get(u) < j) {
             return DFS_BLACK;
-        } else if (d.get(u) < ip) {
+        } else if (d.get(u) < j) {
             return DFS_GRAY;
         } else {
             return DFS_WHITE;
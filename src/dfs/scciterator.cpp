@@ -1,5 +1,4 @@
 #include "sealib/iterator/scciterator.h"
-#include "sealib/graph/graphcreator.h"
 
 namespace Sealib {
 
@@ -7,7 +6,7 @@ SCCIterator::SCCIterator(DirectedGraph const &graph, Consumer p1, BiConsumer p2,
                          BiConsumer p3, Consumer p4)
     : g(graph),
       n(g.getOrder()),
-      t(GraphCreator::transpose(g)),
+      t(g),
       d(g),
       c(n, 3),
       s(n, t, &c),
@@ -1,8 +1,10 @@
 #include "sealib/collection/segmentstack.h"
 #include <math.h>
+#include <algorithm>
 #include <sstream>
 #include <stack>
 #include "sealib/iterator/dfs.h"
+#include "../collection/binaryio.h"
 
 namespace Sealib {
 
@@ -44,10 +46,40 @@ bool SegmentStack::isEmpty() {
 
 uint64_t SegmentStack::size() { return tp * q + hp + lp; }
 
+void SegmentStack::save(std::ostream *out) const {
+    BinaryIO::writeWord(out, q);
+    BinaryIO::writeWord(out, lp);
+    BinaryIO::writeWord(out, hp);
+    BinaryIO::writeWord(out, tp);
+    BinaryIO::writeTuples(out, low, lp);
+    BinaryIO::writeTuples(out, high, hp);
+}
+
+bool SegmentStack::load(std::istream *in) {
+    uint64_t segmentSize = BinaryIO::readWord(in);
+    uint64_t l = BinaryIO::readWord(in), h = BinaryIO::readWord(in);
+    uint64_t t = BinaryIO::readWord(in);
+    if (!*in || segmentSize != q || l > q || h > q) return false;
+    lp = l;
+    hp = h;
+    tp = t;
+    BinaryIO::readTuples(in, &low, lp);
+    BinaryIO::readTuples(in, &high, hp);
+    return static_cast<bool>(*in);
+}
+
 //  -- BASIC --
 
-BasicSegmentStack::BasicSegmentStack(uint64_t segmentSize)
-    : SegmentStack(segmentSize) {}
+BasicSegmentStack::BasicSegmentStack(uint64_t segmentSize,
+                                     uint64_t checkpoints)
+    : SegmentStack(segmentSize),
+      last(INVALID, 0),
+      savedTrailer(INVALID, 0),
+      alignTarget(0),
+      saved(checkpoints * segmentSize),
+      cMax(checkpoints),
+      cFirst(0),
+      cCount(0) {}
 
 void BasicSegmentStack::push(std::pair<uint64_t, uint64_t> u) {
     if (lp < q) {
@@ -55,7 +87,19 @@ void BasicSegmentStack::push(std::pair<uint64_t, uint64_t> u) {
     } else if (hp < q) {
         high[hp++] = u;
     } else {
-        last = low[lp - 1];
+        if (cMax == 0) {
+            last = low[lp - 1];
+        } else {
+            if (cCount == cMax) {
+                // the oldest checkpoint is dropped for good
+                last = saved[cFirst * q + q - 1];
+                cFirst = (cFirst + 1) % cMax;
+                cCount--;
+            }
+            uint64_t c = (cFirst + cCount) % cMax;
+            std::copy(low.begin(), low.end(), saved.begin() + c * q);
+            cCount++;
+        }
         tp++;
         std::swap(low, high);
         hp = 0;
@@ -67,6 +111,19 @@ void BasicSegmentStack::dropAll() {
     lp = 0;
     hp = 0;
     tp = 0;
+    cFirst = 0;
+    cCount = 0;
+}
+
+bool BasicSegmentStack::restoreCheckpoint() {
+    if (cCount == 0) return false;
+    uint64_t c = (cFirst + cCount - 1) % cMax;
+    std::copy(saved.begin() + c * q, saved.begin() + (c + 1) * q, low.begin());
+    cCount--;
+    lp = q;
+    hp = 0;
+    tp--;
+    return true;
 }
 
 void BasicSegmentStack::saveTrailer() {
@@ -78,6 +135,38 @@ void BasicSegmentStack::saveTrailer() {
     }
 }
 
+void BasicSegmentStack::save(std::ostream *out) const {
+    SegmentStack::save(out);
+    BinaryIO::writeTuple(out, last);
+    BinaryIO::writeTuple(out, savedTrailer);
+    BinaryIO::writeWord(out, static_cast<uint64_t>(alignTarget));
+    BinaryIO::writeWord(out, cMax);
+    BinaryIO::writeWord(out, cCount);
+    // the checkpoints are written from oldest to newest
+    for (uint64_t a = 0; a < cCount; a++) {
+        uint64_t c = (cFirst + a) % cMax;
+        for (uint64_t b = 0; b < q; b++) {
+            BinaryIO::writeTuple(out, saved[c * q + b]);
+        }
+    }
+}
+
+bool BasicSegmentStack::load(std::istream *in) {
+    if (!SegmentStack::load(in)) return false;
+    last = BinaryIO::readTuple(in);
+    savedTrailer = BinaryIO::readTuple(in);
+    alignTarget = static_cast<int>(BinaryIO::readWord(in));
+    uint64_t checkpoints = BinaryIO::readWord(in);
+    uint64_t count = BinaryIO::readWord(in);
+    if (!*in || checkpoints != cMax || count > cMax) return false;
+    cFirst = 0;
+    cCount = count;
+    for (uint64_t a = 0; a < cCount * q; a++) {
+        saved[a] = BinaryIO::readTuple(in);
+    }
+    return static_cast<bool>(*in);
+}
+
 bool BasicSegmentStack::isAligned() {
     bool r = false;
     if ((alignTarget == 2 && hp < q) || lp < q) {
@@ -111,6 +200,16 @@ ExtendedSegmentStack::ExtendedSegmentStack(uint64_t size, Graph const &g,
     for (uint64_t a = 0; a < n; a++) m += g.deg(a);
 }
 
+uint64_t ExtendedSegmentStack::estimateByteSize(uint64_t size) {
+    // log2 is 0 or undefined for size <= 1
+    double s = static_cast<double>(size), ls = size > 1 ? log2(s) : 1;
+    uint64_t q = std::max<uint64_t>(static_cast<uint64_t>(ceil(s / ls)), 1);
+    uint64_t l = static_cast<uint64_t>(ceil(ls)) + 1;
+    return 3 * q * sizeof(std::pair<uint64_t, uint64_t>) +
+           (size / q + 1) * sizeof(Trailer) +
+           2 * CompactArray::estimateByteSize(size, l);
+}
+
 uint64_t ExtendedSegmentStack::approximateEdge(uint64_t u, uint64_t k) {
     double g = ceil(graph.deg(u) / static_cast<double>(l));
     uint64_t f = static_cast<uint64_t>(floor((k - 1) / g));
@@ -128,6 +227,9 @@ void ExtendedSegmentStack::storeEdges() {
             big[bp++] = std::pair<uint64_t, uint64_t>(
                 u, k - 1);  // another big vertex is stored
             if (bp > q) throw BigStackFull();
+            if (stats != nullptr && bp > stats->maxBigVertices) {
+                stats->maxBigVertices = bp;
+            }
         } else {  // store an approximation
             uint64_t f = approximateEdge(u, k);
             edges.insert(u, f);
@@ -225,6 +327,38 @@ std::pair<bool, uint64_t> ExtendedSegmentStack::findEdge(uint64_t u,
     return r;
 }
 
+void ExtendedSegmentStack::save(std::ostream *out) const {
+    SegmentStack::save(out);
+    // trailers[tp] may already manage big vertices of the low segment
+    uint64_t t = std::min<uint64_t>(tp + 1, trailers.size());
+    BinaryIO::writeWord(out, t);
+    for (uint64_t a = 0; a < t; a++) {
+        BinaryIO::writeTuple(out, trailers[a].x);
+        BinaryIO::writeWord(out, trailers[a].bi);
+        BinaryIO::writeWord(out, trailers[a].bc);
+    }
+    BinaryIO::writeWord(out, bp);
+    BinaryIO::writeTuples(out, big, bp);
+    table.save(out);
+    edges.save(out);
+}
+
+bool ExtendedSegmentStack::load(std::istream *in) {
+    if (!SegmentStack::load(in)) return false;
+    uint64_t t = BinaryIO::readWord(in);
+    if (!*in || t > trailers.size()) return false;
+    std::fill(trailers.begin(), trailers.end(), Trailer());
+    for (uint64_t a = 0; a < t; a++) {
+        trailers[a].x = BinaryIO::readTuple(in);
+        trailers[a].bi = BinaryIO::readWord(in);
+        trailers[a].bc = BinaryIO::readWord(in);
+    }
+    bp = BinaryIO::readWord(in);
+    if (!*in || bp > big.size()) return false;
+    BinaryIO::readTuples(in, &big, bp);
+    return table.load(in) && edges.load(in);
+}
+
 bool ExtendedSegmentStack::isAligned() {
     bool r = false;
     if (lp == q && tp > 0) {
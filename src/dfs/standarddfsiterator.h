@@ -21,68 +21,83 @@ class StandardDFSIterator : public Iterator<UserCall> {
 
     bool more() override { return !finished; }
 
-    UserCall next() override {
-        if (!s.empty() || state != 0) {
-            if (state == 0) {
-                state = 1;
-                std::pair<uint64_t, uint64_t> x = s.back();
-                s.pop_back();
-                r.u = x.first;
-                r.k = x.second;
-                if (color.operator[](r.u) == DFS_WHITE) {
-                    color.operator[](r.u) = DFS_GRAY;
-                    r.type = UserCall::preprocess;
-                    return r;
+    UserCall next() override { return step(); }
+
+    uint64_t nextBatch(UserCall *buf, uint64_t cap) override {
+        uint64_t c = 0;
+        while (c < cap && !finished) {
+            buf[c++] = step();
+        }
+        return c;
+    }
+
+ private:
+    UserCall step() {
+        while (true) {
+            if (!s.empty() || state != 0) {
+                if (state == 0) {
+                    state = 1;
+                    std::pair<uint64_t, uint64_t> x = s.back();
+                    s.pop_back();
+                    r.u = x.first;
+                    r.k = x.second;
+                    if (color.operator[](r.u) == DFS_WHITE) {
+                        color.operator[](r.u) = DFS_GRAY;
+                        r.type = UserCall::preprocess;
+                        return r;
+                    }
                 }
-            }
-            if (r.k < g.deg(r.u)) {
-                if (state == 1) {
-                    state = 2;
-                    s.push_back({r.u, r.k + 1});
-                    v = g.head(r.u, r.k);
-                    r.type = UserCall::preexplore;
-                    return r;
-                } else {
-                    if (color.operator[](v) == DFS_WHITE) {
-                        s.push_back({v, 0});
+                if (r.k < g.deg(r.u)) {
+                    if (state == 1) {
+                        state = 2;
+                        s.push_back({r.u, r.k + 1});
+                        v = g.head(r.u, r.k);
+                        r.type = UserCall::preexplore;
+                        return r;
                     } else {
+                        if (color.operator[](v) == DFS_WHITE) {
+                            s.push_back({v, 0});
+                        } else {
+                            state = 0;
+                            r.type = UserCall::postexplore;
+                            return r;
+                        }
+                    }
+                } else {
+                    if (state == 1) {
+                        state = 2;
+                        color.operator[](r.u) = DFS_BLACK;
+                        r.type = UserCall::postprocess;
+                        return r;
+                    }
+                    if (r.u != root) {
                         state = 0;
+                        std::pair<uint64_t, uint64_t> p = s.back();
                         r.type = UserCall::postexplore;
+                        r.u = p.first;
+                        r.k = p.second - 1;
                         return r;
                     }
                 }
-            } else {
-                if (state == 1) {
-                    state = 2;
-                    color.operator[](r.u) = DFS_BLACK;
-                    r.type = UserCall::postprocess;
-                    return r;
-                }
-                if (r.u != root) {
-                    state = 0;
-                    std::pair<uint64_t, uint64_t> p = s.back();
-                    r.type = UserCall::postexplore;
-                    r.u = p.first;
-                    r.k = p.second - 1;
-                    return r;
-                }
+                state = 0;
+                continue;
             }
-            state = 0;
-            return next();
-        }
-        for (; nextposRoot < g.getOrder(); nextposRoot++) {
-            if (color[nextposRoot] == DFS_WHITE) {
-                root = nextposRoot;
-                s.push_back({root, 0});
-                return next();
+            bool found = false;
+            for (; nextposRoot < g.getOrder(); nextposRoot++) {
+                if (color[nextposRoot] == DFS_WHITE) {
+                    root = nextposRoot;
+                    s.push_back({root, 0});
+                    found = true;
+                    break;
+                }
             }
+            if (found) continue;
+            finished = true;
+            r.type = UserCall::nop;
+            return r;
         }
-        finished = true;
-        r.type = UserCall::nop;
-        return r;
     }
 
- private:
     Graph const &g;
     uint64_t root;
     uint64_t state;
@@ -0,0 +1,37 @@
+#ifndef SRC_DFS_STATSTIMER_H_
+#define SRC_DFS_STATSTIMER_H_
+#include <chrono>
+
+namespace Sealib {
+/**
+ * Measures the time between its creation and a call to stop() and adds it to
+ * a statistics field. Time that another field gained in the meantime (e.g.
+ * time spent in restorations) can be excluded. If the target is null,
+ * nothing is measured.
+ */
+class StatsTimer {
+ public:
+    explicit StatsTimer(double *t, double const *e = nullptr)
+        : target(t),
+          exclude(e),
+          excludeStart(e == nullptr ? 0 : *e),
+          start(t == nullptr ? std::chrono::steady_clock::time_point()
+                             : std::chrono::steady_clock::now()) {}
+
+    void stop() {
+        if (target == nullptr) return;
+        std::chrono::duration<double> d =
+            std::chrono::steady_clock::now() - start;
+        double excluded = exclude == nullptr ? 0 : *exclude - excludeStart;
+        *target += d.count() - excluded;
+        target = nullptr;
+    }
+
+ private:
+    double *target;
+    double const *exclude;
+    double excludeStart;
+    std::chrono::steady_clock::time_point start;
+};
+}  // namespace Sealib
+#endif  // SRC_DFS_STATSTIMER_H_
@@ -0,0 +1,49 @@
+#include "sealib/iterator/topologicalorder.h"
+
+namespace Sealib {
+
+TopologicalOrder::TopologicalOrder(Graph const &graph)
+    : g(graph), d(g), returned(g.getOrder()) {}
+
+void TopologicalOrder::init() {
+    d.init();
+    returned.clear();
+    u0 = INVALID;
+    backArc = {INVALID, INVALID};
+}
+
+bool TopologicalOrder::more() {
+    if (u0 != INVALID) return true;
+    if (hasCycle()) return false;
+    uint64_t u = nextFinished();
+    if (u == INVALID) return false;
+    // all successors of u must come after u (a self-loop is a cycle, too)
+    returned.insert(u, 1);
+    for (uint64_t k = 0; k < g.deg(u); k++) {
+        uint64_t v = g.head(u, k);
+        if (returned.get(v)) {
+            backArc = {u, v};
+            return false;
+        }
+    }
+    u0 = u;
+    return true;
+}
+
+uint64_t TopologicalOrder::next() {
+    uint64_t u = u0;
+    u0 = INVALID;
+    return u;
+}
+
+uint64_t TopologicalOrder::nextFinished() {
+    while (d.more()) {
+        UserCall a = d.next();
+        if (a.type == UserCall::postprocess) {
+            return a.u;
+        }
+    }
+    return INVALID;
+}
+
+}  // namespace Sealib
@@ -3,11 +3,39 @@
 #include <sealib/graph/graphcreator.h>
 #include <sealib/graph/node.h>
 #include <sealib/iterator/dfs.h>
+#include <vector>
 #include "inoutgraph.h"
 #include "stgraph.h"
 
 namespace Sealib {
 
+/** number of user calls that are read from a DFS iterator at once */
+static const uint64_t SEPARATOR_BATCH = 1024;
+
+/**
+ * Reads the user calls of a DFS iterator in batches. The separators stop
+ * reading early, so up to one batch of user calls is computed in vain.
+ */
+class UserCallReader {
+ public:
+    explicit UserCallReader(Iterator<UserCall> *iterator)
+        : it(iterator), buf(SEPARATOR_BATCH), pos(0), len(0) {}
+
+    UserCall next() {
+        if (pos == len) {
+            len = it->nextBatch(buf.data(), buf.size());
+            pos = 0;
+            if (len == 0) return UserCall();
+        }
+        return buf[pos++];
+    }
+
+ private:
+    Iterator<UserCall> *it;
+    std::vector<UserCall> buf;
+    uint64_t pos, len;
+};
+
 std::vector<std::pair<uint64_t, uint64_t>> Separator::standardESeparate(
     Sealib::Bitset<> const &s, Sealib::Bitset<> const &t,
     Sealib::Graph const &g, int64_t k,
@@ -21,7 +49,8 @@ std::vector<std::pair<uint64_t, uint64_t>> Separator::standardESeparate(
         ispath = false;
         std::vector<uint64_t> path(0);
         Iterator<UserCall> *it = iter(graph, graph.getOrder() - 1);
-        UserCall x = it->next();
+        UserCallReader calls(it);
+        UserCall x = calls.next();
         while (
             (x.type != UserCall::postexplore || x.u != graph.getOrder() - 1) &&
             !ispath) {
@@ -36,7 +65,7 @@ std::vector<std::pair<uint64_t, uint64_t>> Separator::standardESeparate(
                     path.pop_back();
                     break;
             }
-            x = it->next();
+            x = calls.next();
         }
         free(it);
         if (ispath) graph.revertpath(path);
@@ -47,14 +76,15 @@ std::vector<std::pair<uint64_t, uint64_t>> Separator::standardESeparate(
     std::vector<std::pair<uint64_t, uint64_t>> es;
     Sealib::Bitset<> s_reachable = Sealib::Bitset<uint64_t>(graph.getOrder());
     Iterator<UserCall> *it = iter(graph, graph.getOrder() - 1);
-    UserCall x = it->next();
+    UserCallReader calls(it);
+    UserCall x = calls.next();
     while (x.type != UserCall::postexplore || x.u != graph.getOrder() - 1) {
         switch (x.type) {
             case UserCall::preexplore:
                 s_reachable[x.u] = true;
                 break;
         }
-        x = it->next();
+        x = calls.next();
     }
     free(it);
     for (uint64_t i = 0; i < g.getOrder(); i++) {
@@ -0,0 +1,132 @@
+#include "sealib/graph/externalgraph.h"
+#include <algorithm>
+#include "../collection/binaryio.h"
+
+namespace Sealib {
+
+/** words before the offsets in a graph file (n and m) */
+static const uint64_t EXTERNAL_HEADER = 2;
+
+ExternalGraph::ExternalGraph(std::string const &path, uint64_t cacheBytes,
+                             uint64_t blockBytes, uint64_t ahead)
+    : file(path, std::ios::binary),
+      blockWords(std::max<uint64_t>(blockBytes / sizeof(uint64_t), 1)),
+      slots(std::max<uint64_t>(cacheBytes / (blockWords * sizeof(uint64_t)),
+                               1)),
+      readAhead(std::min(ahead, slots - 1)),
+      cache(slots * blockWords),
+      tag(slots, INVALID),
+      referenced(slots),
+      hand(0),
+      lastBlock(INVALID),
+      lastSlot(0),
+      lastVertex(INVALID),
+      lastOffset(0) {
+    if (!file) throw ExternalGraphError();
+    n = BinaryIO::readWord(&file);
+    m = BinaryIO::readWord(&file);
+    fileWords = EXTERNAL_HEADER + n + 1 + m;
+    file.seekg(0, std::ios::end);
+    if (!file || static_cast<uint64_t>(file.tellg()) !=
+                     fileWords * sizeof(uint64_t)) {
+        throw ExternalGraphError();
+    }
+}
+
+void ExternalGraph::write(Graph const &g, std::string const &path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw ExternalGraphError();
+    uint64_t n = g.getOrder(), m = 0;
+    for (uint64_t u = 0; u < n; u++) m += g.deg(u);
+    BinaryIO::writeWord(&out, n);
+    BinaryIO::writeWord(&out, m);
+    uint64_t offset = 0;
+    for (uint64_t u = 0; u < n; u++) {
+        BinaryIO::writeWord(&out, offset);
+        offset += g.deg(u);
+    }
+    BinaryIO::writeWord(&out, offset);
+    for (uint64_t u = 0; u < n; u++) {
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            BinaryIO::writeWord(&out, g.head(u, k));
+        }
+    }
+    out.close();
+    if (!out) throw ExternalGraphError();
+}
+
+uint64_t ExternalGraph::offset(uint64_t u) const {
+    if (u != lastVertex) {
+        lastVertex = u;
+        lastOffset = word(EXTERNAL_HEADER + u);
+    }
+    return lastOffset;
+}
+
+uint64_t ExternalGraph::deg(uint64_t u) const {
+    uint64_t o = offset(u);
+    return word(EXTERNAL_HEADER + u + 1) - o;
+}
+
+uint64_t ExternalGraph::head(uint64_t u, uint64_t k) const {
+    return word(EXTERNAL_HEADER + n + 1 + offset(u) + k);
+}
+
+uint64_t ExternalGraph::word(uint64_t i) const {
+    uint64_t b = i / blockWords;
+    if (b == lastBlock) {
+        stats.hits++;
+    } else {
+        std::unordered_map<uint64_t, uint64_t>::const_iterator s =
+            slotOf.find(b);
+        if (s == slotOf.end()) {
+            stats.misses++;
+            fetch(b);
+            s = slotOf.find(b);
+        } else {
+            stats.hits++;
+        }
+        lastBlock = b;
+        lastSlot = s->second;
+        referenced[lastSlot] = true;
+    }
+    return cache[lastSlot * blockWords + i % blockWords];
+}
+
+void ExternalGraph::fetch(uint64_t b) const {
+    uint64_t blocks = (fileWords + blockWords - 1) / blockWords;
+    uint64_t end = std::min(blocks, b + 1 + readAhead);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(b * blockWords * sizeof(uint64_t)));
+    stats.requests++;
+    for (uint64_t c = b; c < end; c++) {
+        // the sequential read stops at the first block that is cached
+        if (c != b && slotOf.find(c) != slotOf.end()) break;
+        uint64_t s = evict();
+        uint64_t words = std::min(blockWords, fileWords - c * blockWords);
+        BinaryIO::readWords(&file, &cache[s * blockWords], words);
+        if (!file) throw ExternalGraphError();
+        stats.bytesRead += words * sizeof(uint64_t);
+        tag[s] = c;
+        slotOf[c] = s;
+        referenced[s] = c == b;
+    }
+}
+
+uint64_t ExternalGraph::evict() const {
+    while (true) {
+        uint64_t s = hand;
+        hand = (hand + 1) % slots;
+        if (tag[s] == INVALID) return s;
+        if (referenced[s]) {
+            referenced[s] = false;
+        } else {
+            if (tag[s] == lastBlock) lastBlock = INVALID;
+            slotOf.erase(tag[s]);
+            tag[s] = INVALID;
+            return s;
+        }
+    }
+}
+
+}  // namespace Sealib
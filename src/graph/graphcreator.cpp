@@ -228,10 +228,10 @@ UndirectedGraph GraphCreator::triangulated(uint64_t order) {
     nodes.emplace_back(ExtendedNode({{0, 1}, {1, 1}}));
     uint64_t n = 3;
     while (n < order) {
-        uint64_t d = nodes.back().getDegree();
+        uint64_t d1 = nodes[n - 2].getDegree(), d2 = nodes[n - 1].getDegree();
         nodes[n - 2].addAdjacency({n, 0});
         nodes[n - 1].addAdjacency({n, 1});
-        nodes.emplace_back(ExtendedNode({{n - 2, d - 1}, {n - 1, d - 1}}));
+        nodes.emplace_back(ExtendedNode({{n - 2, d1}, {n - 1, d2}}));
         n++;
     }
     return UndirectedGraph(nodes);
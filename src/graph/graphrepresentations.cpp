@@ -7,11 +7,86 @@
 #include <vector>
 #include <algorithm>
 #include <set>
+#include <stdexcept>
+#include <tuple>
 #include "sealib/graph/compactgraph.h"
 #include "sealib/graph/node.h"
 
 using Sealib::Graphrepresentations;
 using Sealib::CompactGraph;
+using Sealib::Graph;
+using Sealib::UndirectedGraph;
+
+uint64_t* Graphrepresentations::graphToStandard(Graph const& g) {
+  uint64_t n = g.getOrder(), m = 0;
+  for (uint64_t u = 0; u < n; u++) m += g.deg(u);
+  uint64_t* a = new uint64_t[n + m + 2];
+  a[0] = n;
+  a[n + 1] = m;
+  uint64_t p = n + 2;
+  for (uint64_t u = 0; u < n; u++) {
+    a[u + 1] = g.deg(u) > 0 ? p : u + 1;
+    for (uint64_t k = 0; k < g.deg(u); k++) {
+      a[p++] = g.head(u, k) + 1;
+    }
+  }
+  return a;
+}
+
+UndirectedGraph Graphrepresentations::standardToUndirected(
+    uint64_t const* a) {
+  uint64_t n = a[0], m = a[n + 1], end = n + m + 2;
+  // begin and end of the adjacency array of vertex v (1-based)
+  auto range = [a, n, end](uint64_t v) {
+    if (a[v] == v) return std::pair<uint64_t, uint64_t>(0, 0);
+    uint64_t w = v + 1;
+    while (w <= n && a[w] == w) w++;
+    return std::pair<uint64_t, uint64_t>(a[v], w <= n ? a[w] : end);
+  };
+  // (tail, head, index) for every arc; sorting once by (tail, head) and once
+  // by (head, tail) lines up every arc with its reverse arc
+  typedef std::tuple<uint64_t, uint64_t, uint64_t> Arc;
+  std::vector<Arc> byTail, byHead;
+  byTail.reserve(m);
+  for (uint64_t v = 1; v <= n; v++) {
+    std::pair<uint64_t, uint64_t> r = range(v);
+    for (uint64_t p = r.first; p < r.second; p++) {
+      byTail.emplace_back(v - 1, a[p] - 1, p - r.first);
+    }
+  }
+  byHead = byTail;
+  std::stable_sort(byTail.begin(), byTail.end(), [](Arc const& x,
+                                                    Arc const& y) {
+    return std::tie(std::get<0>(x), std::get<1>(x)) <
+           std::tie(std::get<0>(y), std::get<1>(y));
+  });
+  std::stable_sort(byHead.begin(), byHead.end(), [](Arc const& x,
+                                                    Arc const& y) {
+    return std::tie(std::get<1>(x), std::get<0>(x)) <
+           std::tie(std::get<1>(y), std::get<0>(y));
+  });
+  UndirectedGraph g(n);
+  for (uint64_t v = 0; v < n; v++) {
+    std::pair<uint64_t, uint64_t> r = range(v + 1);
+    g.getNode(v).getAdj().resize(r.second - r.first);
+  }
+  for (uint64_t i = 0; i < byTail.size(); i++) {
+    uint64_t u, v, k, v2, u2, k2;
+    std::tie(u, v, k) = byTail[i];
+    std::tie(v2, u2, k2) = byHead[i];
+    if (u != u2 || v != v2) {
+      throw std::invalid_argument(
+          "standardToUndirected: the adjacency arrays are not symmetric");
+    }
+    g.getNode(u).getAdj()[k] = {v, k2};
+  }
+  return g;
+}
+
+void Graphrepresentations::standardToSwappedBeginpointer(uint64_t* a) {
+  standardToBeginpointer(a);
+  swapRepresentation(a);
+}
 
 void Graphrepresentations::standardToCrosspointer(uint64_t* a) {
   uint64_t n = a[0], v, u, pv, pu;
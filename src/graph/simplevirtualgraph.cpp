@@ -9,12 +9,10 @@ SimpleVirtualGraph::SimpleVirtualGraph(UndirectedGraph const& g)
 
 uint64_t SimpleVirtualGraph::head(uint64_t u, uint64_t k) const {
     uint64_t i = 0;
-    std::vector<std::pair<uint64_t, uint64_t>> const& adj =
-        g.getNode(u).getAdj();
     for (uint64_t a = 0; a < g.deg(u); a++) {
-        if (present[adj[a].first]) {
+        if (present[g.head(u, a)]) {
             if (i == k) {
-                return adj[a].first;
+                return g.head(u, a);
             }
             i++;
         }
@@ -32,10 +30,8 @@ uint64_t SimpleVirtualGraph::head(uint64_t u, uint64_t k) const {
 
 uint64_t SimpleVirtualGraph::deg(uint64_t u) const {
     uint64_t r = 0;
-    std::vector<std::pair<uint64_t, uint64_t>> const& adj =
-        g.getNode(u).getAdj();
     for (uint64_t a = 0; a < g.deg(u); a++) {
-        if (present[adj[a].first]) r++;
+        if (present[g.head(u, a)]) r++;
     }
     for (uint64_t a = 0; a < virtualAdj[u].size(); a++) {
         if (present[virtualAdj[u][a]]) r++;
@@ -0,0 +1,59 @@
+#include "sealib/graph/transposedgraph.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Sealib {
+
+static uint64_t countArcs(Graph const &g) {
+    uint64_t m = 0;
+    for (uint64_t u = 0; u < g.getOrder(); u++) m += g.deg(u);
+    return m;
+}
+
+/**
+ * @return a 1 per vertex u, followed by a 0 per in-arc of u
+ */
+static std::vector<bool> makeOffsets(Graph const &g,
+                                     std::vector<uint64_t> const &inDeg) {
+    std::vector<bool> bits;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        bits.push_back(1);
+        bits.insert(bits.end(), inDeg[u], 0);
+    }
+    return bits;
+}
+
+static std::vector<uint64_t> inDegrees(Graph const &g) {
+    std::vector<uint64_t> inDeg(g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        for (uint64_t k = 0; k < g.deg(u); k++) inDeg[g.head(u, k)]++;
+    }
+    return inDeg;
+}
+
+TransposedGraph::TransposedGraph(Graph const &g)
+    : n(g.getOrder()),
+      m(countArcs(g)),
+      sources(m, std::max<uint64_t>(n, 2)),
+      offsets(Bitset<uint8_t>(makeOffsets(g, inDegrees(g)))) {
+    // the next free entry of each vertex, relative to its offset
+    std::vector<uint64_t> next(n);
+    for (uint64_t u = 0; u < n; u++) {
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            uint64_t v = g.head(u, k);
+            sources.insert(offset(v) + next[v]++, u);
+        }
+    }
+}
+
+uint64_t TransposedGraph::deg(uint64_t u) const {
+    uint64_t end = u + 1 < n ? offset(u + 1) : m;
+    return end - offset(u);
+}
+
+uint64_t TransposedGraph::head(uint64_t u, uint64_t k) const {
+    return sources.get(offset(u) + k);
+}
+
+}  // namespace Sealib
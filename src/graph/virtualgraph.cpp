@@ -1,138 +1,265 @@
 #include "sealib/graph/virtualgraph.h"
+#include <utility>
+#include <vector>
 
 namespace Sealib {
 
+static uint64_t const WORD_SIZE = 8 * sizeof(uint64_t);
+
+// number of bits needed to store the values 0,...,x
+static uint64_t width(uint64_t x) {
+    uint64_t w = 0;
+    while (x >> w) w++;
+    return w;
+}
+
+static std::vector<bool> makeBits(UndirectedGraph const &g) {
+    std::vector<uint64_t> sizes(g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        sizes[u] = g.deg(u);
+    }
+    return StaticSpaceStorage::makeBitVector(sizes);
+}
+
+static uint64_t countArcs(UndirectedGraph const &g) {
+    uint64_t r = 0;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        r += g.deg(u);
+    }
+    return r;
+}
+
 VirtualGraph::VirtualGraph(UndirectedGraph const &graph)
     : UndirectedGraph(0),
       g(graph),
       n(g.getOrder()),
       presentVertices(n),
+      offsets(Bitset<uint8_t>(makeBits(graph))),
+      // the fields of u take 3*width(deg(u)) <= 3*(deg(u)+1) bits
+      fields(3 * (n + countArcs(graph)) / WORD_SIZE + 2),
       virtualEdges(4 * n) {
     presentVertices.flip();
+    for (uint64_t u = 0; u < n; u++) {
+        Slot s = slot(u);
+        if (g.deg(u) > 0) {
+            set(s, COUNT, g.deg(u));
+            set(s, LAST, g.deg(u) - 1);
+        }
+    }
+}
+
+VirtualGraph::Slot VirtualGraph::slot(uint64_t u) const {
+    return {3 * (offsets.select(u + 1) - 1), width(g.deg(u))};
+}
+
+uint64_t VirtualGraph::get(Slot const &s, Field f) const {
+    if (s.width == 0) return 0;
+    uint64_t p = s.position + f * s.width;
+    uint64_t i = p / WORD_SIZE, o = p % WORD_SIZE;
+    uint64_t r = fields[i] >> o;
+    if (o + s.width > WORD_SIZE) r |= fields[i + 1] << (WORD_SIZE - o);
+    return r & ((uint64_t(1) << s.width) - 1);
+}
+
+void VirtualGraph::set(Slot const &s, Field f, uint64_t v) {
+    if (s.width == 0) return;
+    uint64_t p = s.position + f * s.width, mask = (uint64_t(1) << s.width) - 1;
+    uint64_t i = p / WORD_SIZE, o = p % WORD_SIZE;
+    fields[i] = (fields[i] & ~(mask << o)) | (v << o);
+    if (o + s.width > WORD_SIZE) {
+        uint64_t shift = WORD_SIZE - o;
+        fields[i + 1] = (fields[i + 1] & ~(mask >> shift)) | (v >> shift);
+    }
 }
 
 uint64_t VirtualGraph::deg(uint64_t u) const { return deg(u, true); }
 
 uint64_t VirtualGraph::deg(uint64_t u, bool artificialEdges) const {
-    uint64_t a = 0;
-    for (uint64_t b = 0; b < g.deg(u); b++) {
-        if (presentVertices[g.head(u, b)]) {
-            a++;
-        }
-    }
+    uint64_t a = get(slot(u), COUNT);
     if (artificialEdges && virtualEdges.member(u)) {
         std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
-        if (p.second != INVALID) {
-            a += 2;
-        } else {
-            a++;
-        }
+        if (p.first != INVALID) a++;
+        if (p.second != INVALID) a++;
     }
     return a;
 }
 
-uint64_t VirtualGraph::head(uint64_t u, uint64_t k) const {
+uint64_t VirtualGraph::find(uint64_t u, Slot const &s, uint64_t k) const {
+    if (k == 0) return get(s, FIRST);
+    uint64_t last = get(s, LAST);
+    if (k + 1 == get(s, COUNT)) return last;
     uint64_t a = 0;
-    for (uint64_t b = 0; b < g.deg(u); b++) {
+    for (uint64_t b = get(s, FIRST); b <= last; b++) {
         if (presentVertices[g.head(u, b)]) {
             if (a == k) {
-                return g.head(u, b);
+                return b;
             }
             a++;
         }
     }
-    if (a >= k - 1 && virtualEdges.member(u)) {
-        std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
-        if (a == k) {
-            return p.first;
-        } else if (a == k - 1) {
-            return p.second;
-        }
-    }
     return INVALID;
 }
 
+uint64_t VirtualGraph::findVirtual(uint64_t u, uint64_t j) const {
+    if (!virtualEdges.member(u)) return INVALID;
+    std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+    if (p.first != INVALID) {
+        if (j == 0) return 0;
+        j--;
+    }
+    return j == 0 && p.second != INVALID ? 1 : INVALID;
+}
+
+uint64_t VirtualGraph::head(uint64_t u, uint64_t k) const {
+    Slot s = slot(u);
+    uint64_t a = get(s, COUNT);
+    if (k < a) {
+        return g.head(u, find(u, s, k));
+    }
+    uint64_t i = findVirtual(u, k - a);
+    return i == INVALID ? INVALID : originalHead(u, g.deg(u) + i);
+}
+
 uint64_t VirtualGraph::mate(uint64_t u, uint64_t k) const {
-    uint64_t a = 0;
-    for (uint64_t b = 0; b < g.deg(u); b++) {
-        if (presentVertices[g.head(u, b)]) {
-            if (a == k) {
-                return g.mate(u, b) - (b - a);
-            }
-            a++;
-        }
+    Slot s = slot(u);
+    uint64_t a = get(s, COUNT);
+    if (k < a) {
+        uint64_t b = find(u, s, k);
+        return g.mate(u, b) - (b - k);
     }
-    if (a >= k - 1 && virtualEdges.member(u)) {
-        std::pair<uint64_t, uint64_t> q = virtualEdges.get(head(u, k));
+    if (findVirtual(u, k - a) != INVALID) {
+        uint64_t v = head(u, k);
+        std::pair<uint64_t, uint64_t> q = virtualEdges.get(v);
         assert(q.first == u || q.second == u);
-        return q.first == u && q.second != INVALID ? deg(head(u, k)) - 2
-                                                   : deg(head(u, k)) - 1;
+        uint64_t r = get(slot(v), COUNT);
+        return q.first != u && q.first != INVALID ? r + 1 : r;
     }
     return INVALID;
 }
 
 uint64_t VirtualGraph::index(uint64_t u, uint64_t k) const {
-    uint64_t a = 0;
-    for (uint64_t b = 0; b < g.deg(u); b++) {
+    Slot s = slot(u);
+    uint64_t a = get(s, COUNT);
+    if (k < a) {
+        return find(u, s, k);
+    }
+    uint64_t i = findVirtual(u, k - a);
+    return i == INVALID ? INVALID : g.deg(u) + i;
+}
+
+uint64_t VirtualGraph::originalHead(uint64_t u, uint64_t i) const {
+    if (i < g.deg(u)) {
+        return g.head(u, i);
+    }
+    std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+    return i == g.deg(u) ? p.first : p.second;
+}
+
+uint64_t VirtualGraph::originalMate(uint64_t u, uint64_t i) const {
+    if (i < g.deg(u)) {
+        return g.mate(u, i);
+    }
+    uint64_t v = originalHead(u, i);
+    return virtualEdges.get(v).first == u ? g.deg(v) : g.deg(v) + 1;
+}
+
+uint64_t VirtualGraph::indexOf(uint64_t u, uint64_t v) const {
+    if (virtualEdges.member(u)) {
+        std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+        if (p.first == v) {
+            return g.deg(u);
+        } else if (p.second == v) {
+            return g.deg(u) + 1;
+        }
+    }
+    Slot s = slot(u);
+    uint64_t a = 0, c = get(s, COUNT);
+    for (uint64_t b = get(s, FIRST); a < c; b++) {
         if (presentVertices[g.head(u, b)]) {
-            if (a == k) {
+            if (g.head(u, b) == v) {
                 return b;
             }
             a++;
         }
     }
-    if (a >= k - 1 && virtualEdges.member(u)) {
-        if (a == k) {
-            return g.deg(u) - 2;
-        } else if (a == k - 1) {
-            return g.deg(u) - 1;
-        }
-    }
     return INVALID;
 }
 
 uint64_t VirtualGraph::getOrder() const { return n; }
 
 void VirtualGraph::removeVertex(uint64_t u) {
+    if (!presentVertices[u]) return;
     presentVertices[u] = 0;
     n--;
+    // the edges to u leave the adjacency lists of its neighbours: move the
+    // first and last edge of a neighbour past them if necessary
+    for (uint64_t b = 0; b < g.deg(u); b++) {
+        uint64_t v = g.head(u, b), j = g.mate(u, b);
+        Slot s = slot(v);
+        set(s, COUNT, get(s, COUNT) - 1);
+        if (j == get(s, FIRST)) {
+            uint64_t f = j;
+            while (f < g.deg(v) && !presentVertices[g.head(v, f)]) f++;
+            set(s, FIRST, f);
+        }
+        if (j == get(s, LAST)) {
+            while (j > 0 && !presentVertices[g.head(v, j)]) j--;
+            set(s, LAST, j);
+        }
+    }
+    // the virtual edges of u go away as well
+    if (virtualEdges.member(u)) {
+        std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+        virtualEdges.remove(u);
+        for (uint64_t v : {p.first, p.second}) {
+            if (v != INVALID) removeVirtual(v, u);
+        }
+    }
 }
 
 bool VirtualGraph::hasVertex(uint64_t u) const { return presentVertices[u]; }
 
-void VirtualGraph::addEdge(uint64_t u, uint64_t v) {
+void VirtualGraph::addVirtual(uint64_t u, uint64_t v) {
     if (virtualEdges.member(u)) {
-        // update with second edge
-        virtualEdges.insert(u, {virtualEdges.get(u).first, v});
+        // fill a free place, or update the second edge
+        std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+        if (p.first == INVALID) {
+            p.first = v;
+        } else {
+            p.second = v;
+        }
+        virtualEdges.insert(u, p);
     } else {
         // add first edge
         virtualEdges.insert(u, {v, INVALID});
     }
-    if (virtualEdges.member(v)) {
-        virtualEdges.insert(v, {virtualEdges.get(v).first, u});
+}
+
+void VirtualGraph::removeVirtual(uint64_t u, uint64_t v) {
+    // the other edge keeps its place, so its index stays valid
+    std::pair<uint64_t, uint64_t> p = virtualEdges.get(u);
+    if (p.first == v) {
+        p.first = INVALID;
+    } else if (p.second == v) {
+        p.second = INVALID;
+    }
+    if (p.first == INVALID && p.second == INVALID) {
+        virtualEdges.remove(u);
     } else {
-        virtualEdges.insert(v, {u, INVALID});
+        virtualEdges.insert(u, p);
     }
 }
 
+void VirtualGraph::addEdge(uint64_t u, uint64_t v) {
+    addVirtual(u, v);
+    addVirtual(v, u);
+}
+
 void VirtualGraph::removeEdge(uint64_t u, uint64_t v) {
     // delete edge between u and v
     if (virtualEdges.member(u) && virtualEdges.member(v)) {
-        // search virtual edge {u,v}
-        std::pair<uint64_t, uint64_t> pu = virtualEdges.get(u),
-                                      pv = virtualEdges.get(v);
-        if (pu.second != INVALID) {
-            virtualEdges.insert(
-                u, {pu.first == v ? pu.second : pu.first, INVALID});
-        } else {
-            virtualEdges.remove(u);
-        }
-        if (pv.second != INVALID) {
-            virtualEdges.insert(
-                v, {pv.first == u ? pv.second : pv.first, INVALID});
-        } else {
-            virtualEdges.remove(v);
-        }
+        removeVirtual(u, v);
+        removeVirtual(v, u);
     }
 }
 
@@ -22,19 +22,20 @@ void BCCOutput::traverse(uint64_t u0, Consumer onVertex, BiConsumer onEdge) {
     onVertex(u0);
     outputBackEdges(u0, onEdge);
     uint64_t u = u0, k = 0;
+    EdgeMarker::Cursor c = e->cursor(u);
     while (color.get(u0) != DFS_BLACK) {
         if (k < g.deg(u)) {
             uint64_t v = g.head(u, k);
-            if (e->isTreeEdge(u, k) &&
-                (e->isFullMarked(u, k) || !e->isParent(u, k)) &&
+            if (c.isTreeEdge(k) && (c.isFullMarked(k) || !c.isParent(k)) &&
                 color.get(v) == DFS_WHITE) {
                 color.insert(v, DFS_GRAY);
                 parent.insert(v, g.mate(u, k));
                 onEdge(u, v);
-                if (e->isFullMarked(u, k)) {
+                if (c.isFullMarked(k)) {
                     outputBackEdges(v, onEdge);
                     u = v;
                     k = 0;
+                    c = e->cursor(u);
                 } else {
                     k = g.deg(u);  // retreat
                 }
@@ -49,14 +50,16 @@ void BCCOutput::traverse(uint64_t u0, Consumer onVertex, BiConsumer onEdge) {
                          pu = g.head(u, parent.get(u));
                 u = pu;
                 k = pk + 1;
+                c = e->cursor(u);
             }
         }
     }
 }
 
 void BCCOutput::outputBackEdges(uint64_t v, BiConsumer onEdge) {
+    EdgeMarker::Cursor c = e->cursor(v);
     for (uint64_t l = 0; l < g.deg(v); l++) {
-        if (e->isBackEdge(v, l) && !e->isParent(v, l)) {
+        if (c.isBackEdge(l) && !c.isParent(l)) {
             onEdge(g.head(v, l), v);
         }
     }
@@ -90,19 +93,19 @@ bool BCCIterator::more() {
             edge = g.deg(node);
             [[clang::fallthrough]];
         case WAITING:
-            while (node != startNode || color.get(node) != DFS_BLACK) {
+            for (EdgeMarker::Cursor c = e->cursor(node);
+                 node != startNode || color.get(node) != DFS_BLACK;) {
                 if (edge < g.deg(node)) {
-                    if (e->isTreeEdge(node, edge) &&
-                        (e->isFullMarked(node, edge) ||
-                         !e->isParent(node, edge))) {
-                        if (!e->isFullMarked(node, edge)) {
+                    if (c.isTreeEdge(edge) &&
+                        (c.isFullMarked(edge) || !c.isParent(edge))) {
+                        if (!c.isFullMarked(edge)) {
                             status = RETREAT;
                         }
                         uint64_t v = g.head(node, edge);
                         if (color.get(v) == DFS_WHITE) {
                             color.insert(v, DFS_GRAY);
                             parent.insert(v, g.mate(node, edge));
-                            if (e->isFullMarked(node, edge)) {
+                            if (c.isFullMarked(edge)) {
                                 action = OUTPUT_BACK_EDGES;
                             } else {
                                 action = OUTPUT_VERTEX;
@@ -121,6 +124,7 @@ bool BCCIterator::more() {
                         node = pu;
                         latestNode = node;
                         edge = pk + 1;
+                        c = e->cursor(node);
                     } else {
                         return false;
                     }
@@ -141,9 +145,10 @@ std::pair<uint64_t, uint64_t> BCCIterator::next() {
         status = HAVE_NEXT;
     } else {
         switch (action) {
-            case OUTPUT_BACK_EDGES:
+            case OUTPUT_BACK_EDGES: {
+                EdgeMarker::Cursor c = e->cursor(node);
                 while (tmp < g.deg(node)) {
-                    if (e->isBackEdge(node, tmp) && !e->isParent(node, tmp)) {
+                    if (c.isBackEdge(tmp) && !c.isParent(tmp)) {
                         r = {g.head(node, tmp), node};
                         break;
                     }
@@ -156,6 +161,7 @@ std::pair<uint64_t, uint64_t> BCCIterator::next() {
                 } else {
                     tmp = 0;
                 }
+            }
                 [[clang::fallthrough]];
             case OUTPUT_VERTEX:
                 r = {node, INVALID};
@@ -0,0 +1,75 @@
+#include "sealib/iterator/bcclabeler.h"
+#include <algorithm>
+
+namespace Sealib {
+
+BCCLabeler::BCCLabeler(UndirectedGraph const &graph)
+    : BCCLabeler(std::shared_ptr<EdgeMarker>(new EdgeMarker(graph))) {
+    e->init();
+}
+
+BCCLabeler::BCCLabeler(std::shared_ptr<EdgeMarker> edges)
+    : e(edges), g(e->getGraph()), n(g.getOrder()), label(0, 2) {}
+
+void BCCLabeler::init(BCCEdgeConsumer onEdge, Consumer onComponent) {
+    // every tree edge that is not full marked starts a BCC
+    count = 0;
+    for (uint64_t u = 0; u < n; u++) {
+        EdgeMarker::Cursor c = e->cursor(u);
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            if (c.isTreeEdge(k) && c.isParent(k) && !c.isFullMarked(k)) {
+                count++;
+            }
+        }
+    }
+    label = CompactArray(n, std::max<uint64_t>(count, 2));
+    std::vector<bool> const &roots = e->getCCs();
+    uint64_t id = 0;
+    for (uint64_t r = 0; r < n; r++) {
+        if (roots[r]) labelTree(r, &id, onEdge, onComponent);
+    }
+}
+
+void BCCLabeler::labelTree(uint64_t root, uint64_t *id,
+                           BCCEdgeConsumer onEdge, Consumer onComponent) {
+    uint64_t u = root, k = 0;
+    EdgeMarker::Cursor c = e->cursor(u);
+    while (true) {
+        if (k < g.deg(u)) {
+            if (c.isTreeEdge(k) && c.isParent(k)) {
+                // descend to v and label the edges whose lower end is v
+                uint64_t v = g.head(u, k),
+                         b = c.isFullMarked(k) ? label.get(u) : (*id)++;
+                label.insert(v, b);
+                onEdge(b, u, v);
+                u = v;
+                k = 0;
+                c = e->cursor(u);
+                for (uint64_t l = 0; l < g.deg(u); l++) {
+                    if (c.isBackEdge(l) && !c.isParent(l)) {
+                        onEdge(b, g.head(u, l), u);
+                    }
+                }
+            } else {
+                k++;
+            }
+        } else if (u != root) {
+            // the subtree of u is done: so is the BCC started above u
+            uint64_t p = e->parentEdge(u);
+            if (!c.isFullMarked(p)) onComponent(label.get(u));
+            k = g.mate(u, p) + 1;
+            u = g.head(u, p);
+            c = e->cursor(u);
+        } else {
+            break;
+        }
+    }
+}
+
+uint64_t BCCLabeler::getComponent(uint64_t u, uint64_t k) const {
+    EdgeMarker::Cursor c = e->cursor(u);
+    if (!c.isInitialized(k)) return INVALID;
+    return label.get(c.isParent(k) ? g.head(u, k) : u);
+}
+
+}  // namespace Sealib
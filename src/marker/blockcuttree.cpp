@@ -0,0 +1,147 @@
+#include "sealib/iterator/blockcuttree.h"
+#include <algorithm>
+#include <utility>
+
+namespace Sealib {
+
+static std::shared_ptr<EdgeMarker> markEdges(UndirectedGraph const &g) {
+    std::shared_ptr<EdgeMarker> e(new EdgeMarker(g));
+    e->init();
+    return e;
+}
+
+/**
+ * @return a labeler with all edges labelled
+ */
+static BCCLabeler labelEdges(std::shared_ptr<EdgeMarker> e) {
+    BCCLabeler l(e);
+    l.init();
+    return l;
+}
+
+/**
+ * A vertex is a cut vertex if a block hangs from it that does not contain its
+ * parent edge (for a root: if two blocks hang from it).
+ */
+static std::vector<bool> cutVertices(EdgeMarker const &e) {
+    UndirectedGraph const &g = e.getGraph();
+    std::vector<bool> cut(g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        EdgeMarker::Cursor c = e.cursor(u);
+        uint64_t children = 0;
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            if (c.isTreeEdge(k) && c.isParent(k) && !c.isFullMarked(k)) {
+                children++;
+            }
+        }
+        cut[u] = e.getCCs()[u] ? children > 1 : children > 0;
+    }
+    return cut;
+}
+
+BlockCutTree::BlockCutTree(UndirectedGraph const &graph)
+    : BlockCutTree(markEdges(graph)) {}
+
+BlockCutTree::BlockCutTree(std::shared_ptr<EdgeMarker> edges)
+    : e(edges),
+      g(e->getGraph()),
+      n(g.getOrder()),
+      l(labelEdges(e)),
+      b(l.getCount()),
+      c(0),
+      cut(Bitset<uint8_t>(cutVertices(*e))),
+      top(b, std::max<uint64_t>(n, 2)),
+      parent(0, 2),
+      depth(0, 2) {
+    for (uint64_t u = 0; u < n; u++) {
+        if (isCutVertex(u)) c++;
+    }
+    // the first tree edge of a block is the one that is not full marked
+    for (uint64_t v = 0; v < n; v++) {
+        uint64_t p = e->parentEdge(v);
+        if (p < g.deg(v) && !e->isFullMarked(v, p)) {
+            top.insert(l.getParentComponent(v), g.head(v, p));
+        }
+    }
+    // the blocks are numbered in DFS order, so the parent of a node gets its
+    // depth first
+    uint64_t none = b + c;
+    parent = CompactArray(none, none + 1);
+    depth = CompactArray(none, std::max<uint64_t>(none, 2));
+    for (uint64_t x = 0; x < b; x++) {
+        uint64_t t = top.get(x);
+        if (isCutVertex(t)) {
+            uint64_t y = getNode(t), pb = l.getParentComponent(t);
+            if (pb == INVALID) {
+                parent.insert(y, none);
+                depth.insert(y, 0);
+            } else {
+                parent.insert(y, pb);
+                depth.insert(y, depth.get(pb) + 1);
+            }
+            parent.insert(x, y);
+            depth.insert(x, depth.get(y) + 1);
+        } else {
+            parent.insert(x, none);
+            depth.insert(x, 0);
+        }
+    }
+}
+
+uint64_t BlockCutTree::getParent(uint64_t x) const {
+    uint64_t p = parent.get(x);
+    return p == b + c ? INVALID : p;
+}
+
+uint64_t BlockCutTree::anyBlock(uint64_t u) const {
+    uint64_t pb = l.getParentComponent(u);
+    if (pb != INVALID) return pb;
+    // a root: the block of its first tree edge
+    EdgeMarker::Cursor cu = e->cursor(u);
+    for (uint64_t k = 0; k < g.deg(u); k++) {
+        if (cu.isTreeEdge(k)) return l.getParentComponent(g.head(u, k));
+    }
+    return INVALID;
+}
+
+bool BlockCutTree::sameBlock(uint64_t u, uint64_t v) const {
+    if (u == v) return anyBlock(u) != INVALID;
+    // a block contains the lower ends of its tree edges, and its top vertex
+    uint64_t bu = l.getParentComponent(u), bv = l.getParentComponent(v);
+    return (bu != INVALID && (bu == bv || top.get(bu) == v)) ||
+           (bv != INVALID && top.get(bv) == u);
+}
+
+void BlockCutTree::forEachBlock(uint64_t u, Consumer f) const {
+    uint64_t pb = l.getParentComponent(u);
+    if (pb != INVALID) f(pb);
+    EdgeMarker::Cursor cu = e->cursor(u);
+    for (uint64_t k = 0; k < g.deg(u); k++) {
+        if (cu.isTreeEdge(k) && cu.isParent(k) && !cu.isFullMarked(k)) {
+            f(l.getParentComponent(g.head(u, k)));
+        }
+    }
+}
+
+std::vector<uint64_t> BlockCutTree::blockPath(uint64_t u, uint64_t v) const {
+    uint64_t x = isCutVertex(u) ? getNode(u) : anyBlock(u),
+             y = isCutVertex(v) ? getNode(v) : anyBlock(v);
+    std::vector<uint64_t> up, down;
+    if (x == INVALID || y == INVALID) return up;
+    // climb to the lowest common ancestor
+    while (x != y) {
+        if (depth.get(x) == 0 && depth.get(y) == 0) return {};
+        if (depth.get(x) >= depth.get(y)) {
+            if (x < b) up.push_back(x);
+            x = parent.get(x);
+        } else {
+            if (y < b) down.push_back(y);
+            y = parent.get(y);
+        }
+    }
+    if (x < b) up.push_back(x);
+    up.insert(up.end(), down.rbegin(), down.rend());
+    return up;
+}
+
+}  // namespace Sealib
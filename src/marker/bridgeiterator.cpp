@@ -0,0 +1,96 @@
+#include "sealib/iterator/bridgeiterator.h"
+#include <algorithm>
+
+namespace Sealib {
+
+BridgeIterator::BridgeIterator(UndirectedGraph const &graph)
+    : BridgeIterator(std::shared_ptr<EdgeMarker>(new EdgeMarker(graph))) {
+    e->init();
+}
+
+BridgeIterator::BridgeIterator(std::shared_ptr<EdgeMarker> edges)
+    : e(edges), g(e->getGraph()), n(g.getOrder()) {}
+
+void BridgeIterator::init() { u = k = 0; }
+
+bool BridgeIterator::more() {
+    while (u < n) {
+        // every bridge is output at its lower end
+        EdgeMarker::Cursor c = e->cursor(u);
+        for (; k < g.deg(u); k++) {
+            if (c.isUnmarked(k) && !c.isParent(k)) return true;
+        }
+        u++;
+        k = 0;
+    }
+    return false;
+}
+
+std::pair<uint64_t, uint64_t> BridgeIterator::next() {
+    std::pair<uint64_t, uint64_t> r(g.head(u, k), u);
+    // a vertex has only one parent edge
+    u++;
+    k = 0;
+    return r;
+}
+
+uint64_t TwoEdgeConnectedComponents::countComponents(EdgeMarker const &e) {
+    UndirectedGraph const &g = e.getGraph();
+    uint64_t c = 0;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        uint64_t k = e.parentEdge(u);
+        if (k == g.deg(u) || e.isUnmarked(u, k)) c++;
+    }
+    return c;
+}
+
+static std::unique_ptr<EdgeMarker> markEdges(UndirectedGraph const &g) {
+    std::unique_ptr<EdgeMarker> e(new EdgeMarker(g));
+    e->init();
+    return e;
+}
+
+TwoEdgeConnectedComponents::TwoEdgeConnectedComponents(
+    UndirectedGraph const &g)
+    : TwoEdgeConnectedComponents(*markEdges(g)) {}
+
+TwoEdgeConnectedComponents::TwoEdgeConnectedComponents(EdgeMarker const &e)
+    : count(countComponents(e)),
+      label(e.getGraph().getOrder(), std::max<uint64_t>(count, 2)) {
+    std::vector<bool> const &roots = e.getCCs();
+    uint64_t id = 0;
+    for (uint64_t r = 0; r < e.getGraph().getOrder(); r++) {
+        if (roots[r]) labelTree(e, r, &id);
+    }
+}
+
+void TwoEdgeConnectedComponents::labelTree(EdgeMarker const &e,
+                                           uint64_t root, uint64_t *id) {
+    UndirectedGraph const &g = e.getGraph();
+    label.insert(root, (*id)++);
+    uint64_t u = root, k = 0;
+    EdgeMarker::Cursor c = e.cursor(u);
+    while (true) {
+        if (k < g.deg(u)) {
+            if (c.isTreeEdge(k) && c.isParent(k)) {
+                // descend to the child v; a bridge starts a new component
+                uint64_t v = g.head(u, k);
+                label.insert(v, c.isUnmarked(k) ? (*id)++ : label.get(u));
+                u = v;
+                k = 0;
+                c = e.cursor(u);
+            } else {
+                k++;
+            }
+        } else if (u != root) {
+            uint64_t p = e.parentEdge(u);
+            k = g.mate(u, p) + 1;
+            u = g.head(u, p);
+            c = e.cursor(u);
+        } else {
+            break;
+        }
+    }
+}
+
+}  // namespace Sealib
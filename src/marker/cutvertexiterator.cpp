@@ -19,11 +19,12 @@ CutVertexIterator::CutVertexIterator(std::shared_ptr<EdgeMarker> edges)
 
 void CutVertexIterator::init() {
     for (uint64_t u = 0; u < n; u++) {
+        EdgeMarker::Cursor c = e->cursor(u);
         if (cc[u]) {
             // u is root of a DFS tree
             uint64_t num = 0;
             for (uint64_t k = 0; k < g.deg(u); k++) {
-                if (e->isTreeEdge(u, k) && e->isParent(u, k)) {
+                if (c.isTreeEdge(k) && c.isParent(k)) {
                     num++;
                 }
                 if (num > 1) {
@@ -33,8 +34,7 @@ void CutVertexIterator::init() {
             }
         } else {
             for (uint64_t k = 0; k < g.deg(u); k++) {
-                if (e->isTreeEdge(u, k) && e->isParent(u, k) &&
-                    !e->isFullMarked(u, k)) {
+                if (c.isTreeEdge(k) && c.isParent(k) && !c.isFullMarked(k)) {
                     cut.insert(u);
                     break;
                 }
@@ -69,10 +69,11 @@ void EdgeMarker::markTreeEdges() {
             DFS::visit_nplusm(
                 a, g, &color, &parent,
                 [this, &a](uint64_t u) {
-                    if (u == a /*?*/ || isTreeEdge(u, parent.get(u))) {
+                    Cursor c = cursor(u);
+                    if (u == a /*?*/ || c.isTreeEdge(parent.get(u))) {
                         for (uint64_t k = 0; k < g.deg(u); k++) {
                             uint64_t v = g.head(u, k);
-                            if (isBackEdge(u, k) && isParent(u, k)) {
+                            if (c.isBackEdge(k) && c.isParent(k)) {
                                 // {u,v} is a back edge and u is closer to root:
                                 markParents(v, u);
                             }
@@ -0,0 +1,57 @@
+#include "./simplebridgeiterator.h"
+
+namespace Sealib {
+
+SimpleBridgeIterator::SimpleBridgeIterator(UndirectedGraph const &graph)
+    : g(graph),
+      n(g.getOrder()),
+      number(n, INVALID),
+      lowpt(n),
+      parent(n, INVALID) {}
+
+void SimpleBridgeIterator::init() {
+    for (uint64_t a = 0; a < n; a++) {
+        if (number[a] == INVALID) {
+            findLowpt(a);
+        }
+    }
+}
+
+void SimpleBridgeIterator::findLowpt(uint64_t u0) {
+    s.push({u0, 0});
+    number[u0] = lowpt[u0] = i++;
+    while (!s.empty()) {
+        uint64_t u = s.top().first, k = s.top().second;
+        if (k < g.deg(u)) {
+            s.top().second++;
+            uint64_t v = g.head(u, k);
+            if (k == parent[u]) {
+                // the tree edge we came from (but not a parallel edge)
+            } else if (number[v] == INVALID) {
+                number[v] = lowpt[v] = i++;
+                parent[v] = g.mate(u, k);
+                s.push({v, 0});
+                if (s.size() > smax) smax = s.size();
+            } else if (number[v] < lowpt[u]) {
+                lowpt[u] = number[v];
+            }
+        } else {
+            s.pop();
+            if (u != u0) {
+                uint64_t w = g.head(u, parent[u]);
+                if (lowpt[u] < lowpt[w]) lowpt[w] = lowpt[u];
+                if (lowpt[u] > number[w]) bridges.push_back({w, u});
+            }
+        }
+    }
+}
+
+bool SimpleBridgeIterator::more() { return !bridges.empty(); }
+
+std::pair<uint64_t, uint64_t> SimpleBridgeIterator::next() {
+    std::pair<uint64_t, uint64_t> r = bridges.front();
+    bridges.pop_front();
+    return r;
+}
+
+}  // namespace Sealib
@@ -0,0 +1,51 @@
+#ifndef SRC_MARKER_SIMPLEBRIDGEITERATOR_H_
+#define SRC_MARKER_SIMPLEBRIDGEITERATOR_H_
+#include <deque>
+#include <stack>
+#include <utility>
+#include <vector>
+#include "sealib/graph/undirectedgraph.h"
+#include "sealib/iterator/iterator.h"
+
+namespace Sealib {
+/**
+ * Finds the bridges of an undirected graph with the low-link method (one
+ * word per vertex for the DFS number, the low point and the parent edge).
+ */
+class SimpleBridgeIterator : public Iterator<std::pair<uint64_t, uint64_t>> {
+ public:
+    explicit SimpleBridgeIterator(UndirectedGraph const &graph);
+
+    void init() override;
+
+    bool more() override;
+
+    /**
+     * @return the next bridge {u,v}, where u is the parent of v in the DFS
+     * tree
+     */
+    std::pair<uint64_t, uint64_t> next() override;
+
+    uint64_t byteSize() const {
+        return (number.capacity() + lowpt.capacity() + parent.capacity()) *
+                   sizeof(uint64_t) +
+               smax * sizeof(std::pair<uint64_t, uint64_t>);
+    }
+
+ private:
+    UndirectedGraph const &g;
+    uint64_t n;
+    std::vector<uint64_t> number;
+    std::vector<uint64_t> lowpt;
+    // index of the edge to the parent (INVALID for a root)
+    std::vector<uint64_t> parent;
+    std::stack<std::pair<uint64_t, uint64_t>> s;
+    uint64_t smax = 0;
+    std::deque<std::pair<uint64_t, uint64_t>> bridges;
+    uint64_t i = 0;
+
+    void findLowpt(uint64_t u0);
+};
+}  // namespace Sealib
+
+#endif  // SRC_MARKER_SIMPLEBRIDGEITERATOR_H_
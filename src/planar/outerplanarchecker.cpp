@@ -1,5 +1,7 @@
 #include "sealib/iterator/outerplanarchecker.h"
+#include <algorithm>
 #include <cmath>
+#include <utility>
 #include "sealib/iterator/choicedictionaryiterator.h"
 
 namespace Sealib {
@@ -26,296 +28,402 @@ static std::vector<bool> makeBits(UndirectedGraph const &g) {
 }
 
 OuterplanarChecker::OuterplanarChecker(UndirectedGraph const &graph)
-    : g(graph),
+    : graph(graph),
+      g(graph),
       n(g.getOrder()),
       m(countEdges(graph)),
       d(n),
       di(d),
       tried(n),
+      unclosed(n),
+      ui(unclosed),
       paths(2 * m + 2 * n, 3),
       pathOffset(Bitset<uint8_t>(makeBits(graph))) {}
 
 bool OuterplanarChecker::isOuterplanar() {
+    return isOuterplanar(nullptr, nullptr);
+}
+
+bool OuterplanarChecker::isOuterplanar(CompactArray *outerFace,
+                                       OuterplanarWitness *witness) {
+    bool r;
     if (m > 2 * n - 3) {
-        return false;
+        failure.type = OuterplanarWitness::TOO_MANY_EDGES;
+        r = false;
+    } else {
+        r = removeClosedChains() && removeAllChains() && closeLastFace();
     }
-    if (!removeClosedChains()) {
-        return false;
+    if (witness != nullptr) {
+        *witness = failure;
     }
-    if (!removeAllChains()) {
-        return false;
+    if (r && outerFace != nullptr) {
+        collectOuterFace(outerFace);
     }
-    return true;
+    return r;
 }
 
 static int const MIN_VERTICES = 3;
 
 bool OuterplanarChecker::removeClosedChains() {
-    for (uint64_t round = 0; round < log2(log2(n)) + 1; round++) {
+    // Every vertex of degree 2 is either in D (left to check in this round) or
+    // marked as tried (put off until the next round), so only the first round
+    // has to scan the graph. Chain walks stop at tried vertices, so each vertex
+    // is walked over a constant number of times per round. After
+    // log(log(n))+1 rounds, phase 2 removes the chains that are left.
+    for (uint64_t u = 0; u < n; u++) {
+        if (g.hasVertex(u) && g.deg(u, false) == 2) {
+            d.insert(u);
+        }
+    }
+    double rounds = log2(log2(static_cast<double>(n))) + 1;
+    for (uint64_t round = 0; static_cast<double>(round) < rounds; round++) {
         if (g.getOrder() <= MIN_VERTICES) {
             return true;
         }
-        for (uint64_t u = 0; u < n; u++) {
-            if (g.hasVertex(u) && g.deg(u, false) == 2) {
-                d.insert(u);
+        if (round > 0) {
+            for (uint64_t u = tried.next(0); u != tried.npos;
+                 u = tried.next(u + 1)) {
+                if (g.hasVertex(u) && g.deg(u, false) == 2) {
+                    d.insert(u);
+                }
             }
+            tried.clear();
         }
+        bool found = false, removed = false;
         di.init();
-        if (!di.more()) {
-            return false;
-        }
         while (di.more()) {
             if (g.getOrder() <= MIN_VERTICES) {
                 return true;
             }
             uint64_t u = di.next();
+            d.remove(u);
+            if (g.deg(u, false) != 2) {
+                // lost an edge after it was inserted
+                di.init();  // re-init
+                continue;
+            }
+            found = true;
             ChainData c = chain(u, false);
-            if (c.isClosed) {
-                bool repeatedOnce = false, repeat;
-                do {
-                    bool pathStatus = removeChain(c, false);
-                    if (!pathStatus) {
-                        return false;
-                    }
-                    if (g.getOrder() <= 3) {
-                        return true;
-                    }
-                    if (c.isCycle) {
-                        break;
+            if (!c.isClosed) {
+                putOff(u);
+                di.init();  // re-init
+                continue;
+            }
+            bool repeatedOnce = false, repeat;
+            do {
+                bool pathStatus = removeChain(c);
+                if (!pathStatus) {
+                    return false;
+                }
+                removed = true;
+                if (g.getOrder() <= 3) {
+                    return true;
+                }
+                if (c.isCycle) {
+                    break;
+                }
+                // if an endpoint becomes degree 2, check resulting chain:
+                // either repeat immediately or put it off
+                repeat = false;
+                ChainData next;
+                for (uint64_t e : {c.c1.first, c.c2.first}) {
+                    if (!g.hasVertex(e) || g.deg(e, false) != 2) {
+                        continue;
                     }
-                    // if an endpoint becomes degree 2, check resulting chain:
-                    // either repeat immediately or end loop
-                    repeat = false;
-                    for (uint64_t e : {c.c1.first, c.c2.first}) {
-                        if (g.deg(e, false) == 2) {
-                            ChainData a = chain(e, false);
-                            if (a.isTried || (!a.isClosed && repeatedOnce)) {
-                                // chain could not be reduced further
-                                forEach(a, [this](uint64_t u) {
-                                    if (d.get(u)) d.remove(u);
-                                });
-                                if (!a.isClosed && repeatedOnce) {
-                                    tried[a.c1.first] = 1;
-                                    tried[a.c2.first] = 1;
-                                }
-                                break;
-                            } else if (a.isClosed) {
-                                c = a;
-                                repeatedOnce = true;
-                                repeat = true;
-                            }
+                    ChainData a = chain(e, false, true);
+                    if (a.isTried || !a.isClosed) {
+                        // chain could not be reduced further
+                        putOff(e);
+                        if (!a.isTried && repeatedOnce) {
+                            tried[a.c1.first] = 1;
+                            tried[a.c2.first] = 1;
                         }
+                    } else if (!repeat) {
+                        next = a;
+                        repeat = true;
+                    } else {
+                        d.insert(e);
                     }
-                } while (repeat);
-            } else {
-                forEach(c, [this](uint64_t u) { d.remove(u); });
-            }
+                }
+                c = next;
+                repeatedOnce = true;
+            } while (repeat);
             di.init();  // re-init
         }
-        tried.assign(tried.size(), 0);
+        if (!found) {
+            failure.type = OuterplanarWitness::NO_CHAIN;
+            return false;
+        }
+        if (!removed) {
+            return true;
+        }
     }
     return true;
 }
 
-bool OuterplanarChecker::removeAllChains() {
-    if (g.getOrder() <= MIN_VERTICES) {
-        return true;
+void OuterplanarChecker::putOff(uint64_t u) {
+    tried[u] = 1;
+    if (d.get(u)) d.remove(u);
+    for (uint64_t k = 0; k < 2; k++) {
+        uint64_t p = u, v = g.head(u, k);
+        while (g.deg(v, false) == 2 && !tried[v]) {
+            tried[v] = 1;
+            if (d.get(v)) d.remove(v);
+            uint64_t v2 = g.head(v, g.head(v, 0) == p);
+            p = v;
+            v = v2;
+        }
     }
-    // insert one vertex for each good closed chain
-    tried.assign(tried.size(), 0);
+}
+
+bool OuterplanarChecker::removeAllChains() {
+    // D starts with all vertices of degree 2. A good chain that is not closed
+    // waits in U and is replaced by a virtual edge only when D runs empty, so
+    // closed chains go first. A chain that is not good leaves both until an
+    // endpoint loses an edge: then the neighbours of the endpoint go back to D.
     for (uint64_t u = 0; u < n; u++) {
-        if (g.hasVertex(u) && g.deg(u) == 2 && !tried[u]) {
-            ChainData c = chain(u);
-            forEach(c, [this](uint64_t u) { tried[u] = 1; });
-            if (c.isClosed && c.isGood &&
-                !d.get(g.head(c.c1.first, c.c1.second))) {
-                d.insert(g.head(c.c1.first, c.c1.second));
-            }
+        if (g.hasVertex(u) && g.deg(u) == 2 && !d.get(u)) {
+            d.insert(u);
         }
     }
-    di.init();
-    if (!di.more()) {
-        return false;
-    }
-    tried.assign(tried.size(), 0);
-    uint64_t next = INVALID;
-    while (di.more()) {
-        if (g.getOrder() <= MIN_VERTICES) {
-            return true;
-        }
+    while (g.getOrder() > MIN_VERTICES) {
         uint64_t u;
-        if (next == INVALID) {
+        bool fromD;
+        di.init();
+        ui.init();
+        if (di.more()) {
             u = di.next();
             d.remove(u);
+            fromD = true;
+        } else if (ui.more()) {
+            u = ui.next();
+            unclosed.remove(u);
+            fromD = false;
         } else {
-            u = next;
-            next = INVALID;
+            failure.type = OuterplanarWitness::NO_CHAIN;
+            return false;
+        }
+        if (!g.hasVertex(u) || g.deg(u) != 2) {
+            continue;
         }
         ChainData c = chain(u);
-        if (c.isGood) {
-            if (!c.isClosed) {
-                g.addEdge(c.c1.first, c.c2.first);
+        if (c.isCycle) {
+            // the vertices that are left form the last face
+            return true;
+        }
+        if (!c.isGood || (fromD && !c.isClosed)) {
+            forEach(c, [this](uint64_t v) {
+                if (d.get(v)) d.remove(v);
+                if (unclosed.get(v)) unclosed.remove(v);
+            });
+            if (c.isGood) {
+                unclosed.insert(u);
             }
-            bool pathStatus = removeChain(c);
-            if (!pathStatus) {
-                return false;
+            continue;
+        }
+        if (!removeChain(c) || (!c.isClosed && !link(c))) {
+            return false;
+        }
+        // an endpoint may have degree 2 now, or its chains may have become good
+        for (uint64_t e : {c.c1.first, c.c2.first}) {
+            if (g.deg(e) > 4) {
+                continue;
             }
-            if (c.isClosed) {
-                // check if an endpoint got degree 2, 3 or 4
-                for (uint64_t e : {c.c1.first, c.c2.first}) {
-                    if (g.deg(e) == 2) {
-                        // force evaluation of resulting chain
-                        next = e;
-                    } else if (g.deg(e) == 3 || g.deg(e) == 4) {
-                        for (uint64_t k = 0; k < g.deg(e); k++) {
-                            if (g.deg(g.head(e, k)) == 2) {
-                                if (tried[g.head(e, k)]) {
-                                    assert(next == INVALID &&
-                                           "Cannot prioritize two chains at "
-                                           "the same time");
-                                    next = g.head(e, k);
-                                    // we need not set tried[]=false because
-                                    // the vertices are deleted anyway in
-                                    // the next iteration
-                                } else {
-                                    d.insert(g.head(e, k));
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                g.addEdge(c.c1.first, c.c2.first);
+            if (g.deg(e) == 2 && !d.get(e)) {
+                d.insert(e);
             }
-        } else {
-            // remove obsolete vertices from D
-            forEach(c, [this](uint64_t u) {
-                if (d.get(u)) {
-                    d.remove(u);
+            for (uint64_t k = 0; k < g.deg(e); k++) {
+                uint64_t v = g.head(e, k);
+                if (g.deg(v) == 2 && !d.get(v)) {
+                    d.insert(v);
                 }
-            });
-            for (std::pair<uint64_t, uint64_t> e : {c.c1, c.c2}) {
-                tried[g.head(e.first, e.second)] = true;
             }
         }
-        di.init();
     }
     return true;
 }
 
+bool OuterplanarChecker::link(ChainData const &c) {
+    uint64_t u = c.c1.first, v = c.c2.first;
+    // the virtual edges of a vertex stand for paths on the outer face, and
+    // each vertex has only two edges on the outer face
+    if (u == v || g.deg(u) - g.deg(u, false) == 2 ||
+        g.deg(v) - g.deg(v, false) == 2) {
+        failure.type = OuterplanarWitness::NO_CHAIN;
+        return false;
+    }
+    g.addEdge(u, v);
+    // the new edge borders the face of the removed chain
+    uint64_t i = g.indexOf(u, v);
+    paths.insert(pathIndex(u, i), 1);
+    paths.insert(pathIndex(v, g.originalMate(u, i)), 1);
+    return true;
+}
+
 OuterplanarChecker::ChainData OuterplanarChecker::chain(uint64_t u,
-                                                        bool phase2) {
+                                                        bool phase2,
+                                                        bool stopAtTried) {
     ChainData r;
     assert(g.deg(u, phase2) == 2);
     uint64_t v1 = g.head(u, 0), v2 = g.head(u, 1);
-    uint64_t p1 = u, p2 = u;
-    while (g.deg(v1, phase2) == 2 || g.deg(v2, phase2) == 2) {
+    // p1 and p2 are the last inner vertices, k1 and k2 their edges to v1, v2
+    uint64_t p1 = u, p2 = u, k1 = 0, k2 = 1;
+    uint64_t d1 = g.deg(v1, phase2), d2 = g.deg(v2, phase2);
+    while (d1 == 2 || d2 == 2) {
         if (v1 == u || v2 == u) {
             // cycle detected (a cycle is a valid chain as long as the two
             // chosen endpoints are adjacent)
             r.isCycle = true;
             break;
         }
-        if (g.deg(v1, phase2) == 2) {
-            uint64_t k1 = g.head(v1, 0) == p1;
-            p1 = v1;
+        if (d1 == 2) {
             if (!phase2 && tried[v1]) {
                 r.isTried = true;
+                if (stopAtTried) return r;
             }
+            k1 = g.head(v1, 0) == p1;
+            p1 = v1;
             v1 = g.head(v1, k1);
+            d1 = g.deg(v1, phase2);
         }
-        if (g.deg(v2, phase2) == 2) {
-            uint64_t k2 = g.head(v2, 0) == p2;
-            p2 = v2;
+        if (d2 == 2) {
             if (!phase2 && tried[v2]) {
                 r.isTried = true;
+                if (stopAtTried) return r;
             }
+            k2 = g.head(v2, 0) == p2;
+            p2 = v2;
             v2 = g.head(v2, k2);
+            d2 = g.deg(v2, phase2);
         }
     }
     if (r.isCycle) {
         uint64_t a = g.head(u, 0);
-        r.c1 = {u, 1}, r.c2 = {a, g.head(a, 0) == u};
+        r.c1 = {u, g.index(u, 1)};
+        r.c2 = {a, g.index(a, g.head(a, 0) == u)};
         r.isClosed = true, r.isGood = true;
     } else {
         // find edges pointing inwards
-        uint64_t k1 = INVALID, k2 = INVALID;
-        for (uint64_t k = 0; k < g.deg(v1, phase2); k++) {
-            if (g.head(v1, k) == p1) {
-                k1 = k;
-                break;
-            }
-        }
-        for (uint64_t k = 0; k < g.deg(v2, phase2); k++) {
-            if (g.head(v2, k) == p2) {
-                k2 = k;
-                break;
-            }
-        }
-        assert(k1 != INVALID && k2 != INVALID);
-        r.c1 = {v1, k1}, r.c2 = {v2, k2};
-        forEdge(v1, v2, [&r](uint64_t, uint64_t) { r.isClosed = true; });
-        r.isGood = g.deg(v1, phase2) <= 4 || g.deg(v2, phase2) <= 4;
+        r.c1 = {v1, g.originalMate(p1, g.index(p1, k1))};
+        r.c2 = {v2, g.originalMate(p2, g.index(p2, k2))};
+        r.isClosed = closingEdge(r).first != INVALID;
+        r.isGood = d1 <= 4 || d2 <= 4;
     }
     return r;
 }
 
-bool OuterplanarChecker::removeChain(ChainData const &c, bool phase2) {
+std::pair<uint64_t, uint64_t> OuterplanarChecker::closingEdge(
+    ChainData const &c) const {
+    // scan the endpoint of lower degree only
+    uint64_t u = c.c1.first, v = c.c2.first;
+    if (g.deg(v) < g.deg(u)) {
+        std::swap(u, v);
+    }
+    uint64_t i = g.indexOf(u, v);
+    return {i == INVALID ? INVALID : u, i};
+}
+
+bool OuterplanarChecker::removeChain(ChainData const &c) {
     bool r = true;
+    std::pair<uint64_t, uint64_t> e =
+        c.isCycle ? std::make_pair(INVALID, INVALID) : closingEdge(c);
     forEach(
         c,
-        [this, phase2](uint64_t u) {
+        [this](uint64_t u) {
             g.removeVertex(u);
-            if (!phase2 || d.get(u)) d.remove(u);
+            if (d.get(u)) d.remove(u);
+            if (unclosed.get(u)) unclosed.remove(u);
         },
-        [this, &r](uint64_t u, uint64_t k) {
-            if (!incrementPaths(u, k)) {
+        [this, &r](uint64_t u, uint64_t i) {
+            if (!incrementPaths(u, i)) {
                 r = false;
             }
         });
-    if (!c.isCycle) {
+    if (e.first != INVALID) {
         // increment path counter between endpoints
-        forEdge(c.c1.first, c.c2.first, [this, &r](uint64_t u, uint64_t k) {
-            if (!incrementPaths(u, k)) {
-                r = false;
-            }
-        });
+        if (!incrementPaths(e.first, e.second) ||
+            !incrementPaths(g.originalHead(e.first, e.second),
+                            g.originalMate(e.first, e.second))) {
+            r = false;
+        }
     }
     return r;
 }
 
-bool OuterplanarChecker::incrementPaths(uint64_t u, uint64_t k) {
-    uint64_t a = (pathOffset.select(u + 1) - u - 1) + g.index(u, k);
+uint64_t OuterplanarChecker::pathIndex(uint64_t u, uint64_t i) const {
+    return (pathOffset.select(u + 1) - u - 1) + i;
+}
+
+bool OuterplanarChecker::incrementPaths(uint64_t u, uint64_t i) {
+    uint64_t a = pathIndex(u, i);
     paths.insert(a, paths.get(a) + 1);
-    return paths.get(a) <= 2;
+    if (paths.get(a) > 2) {
+        if (failure.type == OuterplanarWitness::NONE) {
+            failure.type = OuterplanarWitness::SHARED_EDGE;
+            failure.u = u;
+            failure.v = g.originalHead(u, i);
+        }
+        return false;
+    }
+    return true;
 }
 
-void OuterplanarChecker::forEdge(uint64_t v1, uint64_t v2,
-                                 std::function<void(uint64_t, uint64_t)> f) {
-    for (uint64_t k = 0; k < g.deg(v1); k++) {
-        if (g.head(v1, k) == v2) {
-            f(v1, k);
-            break;
+bool OuterplanarChecker::closeLastFace() {
+    // the vertices that are left over form the last face
+    bool r = true;
+    for (uint64_t u = 0; u < n; u++) {
+        if (g.hasVertex(u)) {
+            for (uint64_t k = 0; k < g.deg(u); k++) {
+                if (!incrementPaths(u, g.index(u, k))) {
+                    r = false;
+                }
+            }
         }
     }
-    for (uint64_t k = 0; k < g.deg(v2); k++) {
-        if (g.head(v2, k) == v1) {
-            f(v2, k);
-            break;
+    return r;
+}
+
+uint64_t OuterplanarChecker::faces(uint64_t u, uint64_t k) const {
+    return paths.get(pathIndex(u, k));
+}
+
+void OuterplanarChecker::collectOuterFace(CompactArray *outerFace) const {
+    *outerFace = CompactArray(n, std::max<uint64_t>(n, 2));
+    if (n <= 2) {
+        for (uint64_t u = 0; u < n; u++) {
+            outerFace->insert(u, (u + 1) % n);
         }
+        return;
     }
+    // walk along the edges that border only one face
+    uint64_t p = INVALID, u = 0;
+    do {
+        uint64_t v = INVALID;
+        for (uint64_t k = 0; k < graph.deg(u); k++) {
+            if (graph.head(u, k) != p && faces(u, k) == 1) {
+                v = graph.head(u, k);
+                break;
+            }
+        }
+        assert(v != INVALID);
+        outerFace->insert(u, v);
+        p = u;
+        u = v;
+    } while (u != 0);
 }
 
 void OuterplanarChecker::forEach(OuterplanarChecker::ChainData const &c,
                                  Consumer v, BiConsumer e) {
-    uint64_t u = g.head(c.c1.first, c.c1.second),
+    // the edges are passed on by their original index (see
+    // VirtualGraph::originalHead()), so the endpoints are never scanned
+    uint64_t u = g.originalHead(c.c1.first, c.c1.second),
              k = g.head(u, 0) == c.c1.first;
     e(c.c1.first, c.c1.second);
-    e(u, g.head(u, 0) != c.c1.first);
+    e(u, g.originalMate(c.c1.first, c.c1.second));
     while (u != c.c2.first) {
-        uint64_t u2 = g.head(u, k);
-        e(u, k);                    // forward edge
-        e(u2, g.head(u2, 0) != u);  // backward edge
+        uint64_t u2 = g.head(u, k), i = g.index(u, k);
+        e(u, i);                      // forward edge
+        e(u2, g.originalMate(u, i));  // backward edge
         v(u);
         uint64_t k2 = g.hasVertex(u) ? g.head(u2, 0) == u : 0;
         u = u2;
@@ -1,4 +1,5 @@
 #include "./recursivesubgraph.h"
+#include <algorithm>
 #include <iostream>
 
 /**
@@ -14,32 +15,7 @@ Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
                                              const bitset_t &a) :
     SubGraph(sidx_, ridx_, stack_),
     vSelect(initializeVSelect(v)), aSelect(initializeASelect(a)) {
-    SubGraph *r = stack->clientList[stack_t::refs[ridx]];
-
-    bitset_t p(rank_a(aSelect.size()));
-    bitset_t q(rank_v(vSelect.size()));
-
-    uint64_t degRSum = 0;
-    uint64_t degSum = 0;
-    for (uint64_t uR = 1; uR <= vSelect.size(); uR++) {  // iterate all vertices of G_r
-        uint64_t u = phiInv(uR);
-        uint64_t degR = r->degree(uR);
-        if (u > 0) {  // if u exists in G_this
-            uint64_t deg = 0;
-            for (uint64_t i = degRSum; i < degRSum + degR; i++) {
-                uint64_t pinv = psiInv(i + 1);
-                deg += pinv == 0 ? 0 : 1;
-            }
-            degSum += deg;
-            if (deg > 0) {
-                q[u - 1] = 1;
-                p[degSum - 1] = 1;
-            }
-        }
-        degRSum += degR;
-    }
-    pSelect = new RankSelect(std::move(p));
-    qSelect = new RankSelect(std::move(q));
+    initializeDegrees();
 }
 
 Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
@@ -49,22 +25,99 @@ Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
                                              bitset_t &&a) :
     SubGraph(sidx_, ridx_, stack_),
     vSelect(initializeVSelect(v)), aSelect(initializeASelect(a)) {
-    SubGraph *r = stack->clientList[stack_t::refs[ridx]];
+    initializeDegrees();
+}
 
-    bitset_t p(rank_a(aSelect.size()));
-    bitset_t q(rank_v(vSelect.size()));
+Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
+                                             uint64_t sidx_,
+                                             uint64_t ridx_,
+                                             const stack_t::VertexPredicate &v,
+                                             const stack_t::ArcPredicate &a) :
+    RecursiveSubGraph(stack_, sidx_, ridx_,
+                      filter(stack_, sidx_, ridx_, v, a)) {}
 
+Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
+                                             uint64_t sidx_,
+                                             uint64_t ridx_,
+                                             std::pair<bitset_t, bitset_t> &&vaR) :
+    SubGraph(sidx_, ridx_, stack_),
+    vSelect(std::move(vaR.first)), aSelect(std::move(vaR.second)) {
+    initializeDegrees();
+}
+
+std::pair<Sealib::SubGraph::bitset_t, Sealib::SubGraph::bitset_t>
+Sealib::RecursiveSubGraph::filter(stack_t *stack,
+                                  uint64_t sidx,
+                                  uint64_t ridx,
+                                  const stack_t::VertexPredicate &v,
+                                  const stack_t::ArcPredicate &a) {
+    SubGraph *r = stack->clientList[stack->refs[ridx]];
+    const bitset_t &pR = r->pSelect->getBitset();
+    const bitset_t &qR = r->qSelect->getBitset();
+    // vertices and arcs of the reference graph that are in G_sidx-1
+    const bitset_t *vL = nullptr, *aL = nullptr;
+    if (stack->refs[ridx] != sidx - 1) {
+        auto *gL = reinterpret_cast<RecursiveSubGraph *>(stack->clientList[sidx - 1]);
+        vL = &gL->vSelect.getBitset();
+        aL = &gL->aSelect.getBitset();
+    }
+
+    bitset_t vR(qR.size());
+    bitset_t aR(pR.size());
+    uint64_t u = 0;
+    for (uint64_t uR = 0; uR < vR.size(); uR++) {
+        if (vL == nullptr || (*vL)[uR]) {
+            u++;
+            if (v(u)) {
+                vR[uR] = 1;
+            }
+        }
+    }
+
+    // u and k count the vertices and arcs of G_sidx-1 while the arcs of the
+    // reference graph are visited in order
+    u = 0;
     uint64_t degRSum = 0;
-    uint64_t degSum = 0;
-    for (uint64_t uR = 1; uR <= vSelect.size(); uR++) {  // iterate all vertices of G_r
-        uint64_t u = phiInv(uR);
-        uint64_t degR = r->degree(uR);
-        if (u > 0) {  // if u exists in G_this
-            uint64_t deg = 0;
-            for (uint64_t i = degRSum; i < degRSum + degR; i++) {
-                uint64_t pinv = psiInv(i + 1);
-                deg += pinv == 0 ? 0 : 1;
+    for (uint64_t uR = 0; uR < vR.size(); uR++) {
+        uint64_t degR = qR[uR] ? pR.next(degRSum) + 1 - degRSum : 0;
+        if (vL == nullptr || (*vL)[uR]) {
+            u++;
+            uint64_t k = 0;
+            for (uint64_t i = degRSum; vR[uR] && i < degRSum + degR; i++) {
+                if (aL == nullptr || (*aL)[i]) {
+                    k++;
+                    if (a ? a(u, k) : vR[r->head(uR + 1, i - degRSum + 1) - 1]) {
+                        aR[i] = 1;
+                    }
+                }
             }
+        }
+        degRSum += degR;
+    }
+    return std::pair<bitset_t, bitset_t>(std::move(vR), std::move(aR));
+}
+
+void Sealib::RecursiveSubGraph::initializeDegrees() {
+    SubGraph *r = stack->clientList[stack->refs[ridx]];
+    const bitset_t &v = vSelect.getBitset();
+    const bitset_t &a = aSelect.getBitset();
+    const bitset_t &pR = r->pSelect->getBitset();
+    const bitset_t &qR = r->qSelect->getBitset();
+
+    bitset_t p(a.count(0, a.size()));
+    bitset_t q(v.count(0, v.size()));
+
+    // the arcs of G_r are numbered vertex by vertex, so one pass over the
+    // vertices of G_r finds the arc range of each vertex in pR, and the
+    // degree in G_this is the number of arcs of that range left in a
+    uint64_t u = 0;
+    uint64_t degRSum = 0;
+    uint64_t degSum = 0;
+    for (uint64_t uR = 0; uR < v.size(); uR++) {  // iterate all vertices of G_r
+        uint64_t degR = qR[uR] ? pR.next(degRSum) + 1 - degRSum : 0;
+        if (v[uR]) {  // if uR exists in G_this
+            u++;
+            uint64_t deg = a.count(degRSum, degRSum + degR);
             degSum += deg;
             if (deg > 0) {
                 q[u - 1] = 1;
@@ -78,13 +131,13 @@ Sealib::RecursiveSubGraph::RecursiveSubGraph(stack_t *stack_,
 }
 
 uint64_t Sealib::RecursiveSubGraph::head(uint64_t u, uint64_t k) const {
-    SubGraph *r = stack->clientList[stack_t::refs[ridx]];
+    SubGraph *r = stack->clientList[stack->refs[ridx]];
     return phiInv(r->head(r->gInv(psi(g(u, k)))));
 }
 
 std::tuple<uint64_t, uint64_t>
 Sealib::RecursiveSubGraph::mate(uint64_t u, uint64_t k) const {
-    SubGraph *r = stack->clientList[stack_t::refs[ridx]];
+    SubGraph *r = stack->clientList[stack->refs[ridx]];
     return gInv(psiInv(r->g(r->mate(r->gInv(psi(g(u, k)))))));
 }
 
@@ -125,33 +178,72 @@ uint64_t Sealib::RecursiveSubGraph::psiInv(uint64_t a) const {
 }
 
 Sealib::SubGraph::bitset_t Sealib::RecursiveSubGraph::initializeVSelect(const bitset_t &v) {
-    if (stack_t::refs[ridx] == sidx - 1) {
+    if (stack->refs[ridx] == sidx - 1) {
         return v;
     } else {
         auto *gL = reinterpret_cast<RecursiveSubGraph *>(stack->clientList[sidx - 1]);
-        bitset_t vR(gL->vSelect.size());
-
-        for (uint64_t i = 0; i < v.size(); i++) {
-            if (v[i]) {
-                vR[gL->select_v(i + 1) - 1] = 1;
-            }
-        }
-        return vR;
+        return compose(v, gL->vSelect.getBitset());
     }
 }
 
 Sealib::SubGraph::bitset_t Sealib::RecursiveSubGraph::initializeASelect(const bitset_t &a) {
-    if (stack_t::refs[ridx] == sidx - 1) {
+    if (stack->refs[ridx] == sidx - 1) {
         return a;
     } else {
         auto *gL = reinterpret_cast<RecursiveSubGraph *>(stack->clientList[sidx - 1]);
-        bitset_t aR(gL->aSelect.size());
+        return compose(a, gL->aSelect.getBitset());
+    }
+}
 
-        for (uint64_t i = 0; i < a.size(); i++) {
-            if (a[i]) {
-                aR[gL->select_a(i + 1) - 1] = 1;
-            }
-        }
-        return aR;
+static uint64_t popcount(uint64_t x) {
+    return static_cast<uint64_t>(__builtin_popcountll(x));
+}
+
+/**
+ * @return position of the r-th (0-based) set bit of w, a byte at a time
+ */
+static uint64_t selectInWord(uint64_t w, uint64_t r) {
+    uint64_t b = 0;
+    for (;; b += 8) {
+        uint64_t c = popcount((w >> b) & 0xff);
+        if (r < c) break;
+        r -= c;
+    }
+    uint64_t x = (w >> b) & 0xff;
+    for (; r > 0; r--) x &= x - 1;
+    return b + static_cast<uint64_t>(__builtin_ctzll(x));
+}
+
+/**
+ * Scatter the lowest bits of x to the set bits of the mask m: the i-th set
+ * bit of m is kept iff bit i of x is set. Only the minority of the bits of x
+ * is placed one by one.
+ */
+static uint64_t deposit(uint64_t x, uint64_t m) {
+    uint64_t c = popcount(m);
+    uint64_t all = c == 64 ? ~uint64_t(0) : (uint64_t(1) << c) - 1;
+    x &= all;
+    bool dense = popcount(x) > c / 2;
+    uint64_t y = dense ? ~x & all : x, r = 0;
+    for (; y != 0; y &= y - 1) {
+        r |= uint64_t(1)
+             << selectInWord(m, static_cast<uint64_t>(__builtin_ctzll(y)));
+    }
+    return dense ? m & ~r : r;
+}
+
+Sealib::SubGraph::bitset_t Sealib::RecursiveSubGraph::compose(const bitset_t &x,
+                                                              const bitset_t &s) {
+    // a word of s takes as many bits of x as it has set bits
+    bitset_t xR(s.size());
+    uint64_t i = 0;
+    for (uint64_t p = 0; p < s.size() && i < x.size(); p += 64) {
+        uint64_t len = std::min<uint64_t>(64, s.size() - p);
+        uint64_t m = s.getBits(p, len);
+        uint64_t c = std::min(popcount(m), x.size() - i);
+        uint64_t y = x.getBits(i, c);
+        i += c;
+        if (y != 0) xR.setBits(p, len, deposit(y, m));
     }
+    return xR;
 }
@@ -2,6 +2,7 @@
 #define SRC_SUBGRAPH_RECURSIVESUBGRAPH_H_
 #include <sealib/dictionary/rankselect.h>
 #include <tuple>
+#include <utility>
 #include "./subgraph.h"
 
 namespace Sealib {
@@ -13,6 +14,35 @@ class RecursiveSubGraph : public SubGraph {
     bitset_t initializeVSelect(const bitset_t &v);
     bitset_t initializeASelect(const bitset_t &v);
 
+    /**
+     * Build p and q from vSelect, aSelect and the p and q bitsets of the
+     * reference graph with one pass over the vertices of the reference graph.
+     * EFFICIENCY: O(n_r + m_r/w) word operations
+     */
+    void initializeDegrees();
+
+    /**
+     * @param x bitset over the set bits of s
+     * @param s bitset with x.size() set bits
+     * @return bitset of the size of s where bit j is set iff j is the i-th
+     * set bit of s and x[i] is set
+     */
+    static bitset_t compose(const bitset_t &x, const bitset_t &s);
+
+    /**
+     * Evaluate the predicates on the vertices and arcs of G_sidx-1 in one pass
+     * over the reference graph.
+     * @return vertex and arc bitsets over the reference graph
+     */
+    static std::pair<bitset_t, bitset_t> filter(
+        stack_t *stack, uint64_t sidx, uint64_t ridx,
+        const stack_t::VertexPredicate &v, const stack_t::ArcPredicate &a);
+
+    RecursiveSubGraph(stack_t *stack,
+                      uint64_t sidx_,
+                      uint64_t ridx_,
+                      std::pair<bitset_t, bitset_t> &&vaR);
+
     inline uint64_t select_v(uint64_t i) const {
         return vSelect.select(i);
     }
@@ -42,6 +72,17 @@ class RecursiveSubGraph : public SubGraph {
                       Sealib::Bitset<uint8_t> &&v,
                       Sealib::Bitset<uint8_t> &&a);
 
+    /**
+     * @param v keep the vertex u of G_sidx-1 iff v(u)
+     * @param a keep the k-th arc of a kept vertex u iff a(u, k); if a is
+     * empty, keep the arcs whose head is kept (induced subgraph)
+     */
+    RecursiveSubGraph(stack_t *stack,
+                      uint64_t sidx_,
+                      uint64_t ridx_,
+                      const stack_t::VertexPredicate &v,
+                      const stack_t::ArcPredicate &a);
+
     uint64_t head(uint64_t u, uint64_t k) const override;
     std::tuple<uint64_t, uint64_t> mate(uint64_t u, uint64_t k) const override;
 
@@ -54,6 +95,10 @@ class RecursiveSubGraph : public SubGraph {
     uint64_t phiInv(uint64_t u) const final;
     uint64_t psiInv(uint64_t a) const final;
 
+    uint64_t byteSize() const override {
+        return SubGraph::byteSize() + vSelect.byteSize() + aSelect.byteSize();
+    }
+
     ~RecursiveSubGraph() override;
 };
 }  // namespace Sealib
@@ -165,6 +165,34 @@ class SubGraph {
         return std::tuple<uint64_t, uint64_t>(a, r - b);
     }
 
+    /**
+     * @param a bitset over the arcs of this graph
+     * @return bitset over the vertices of this graph, a vertex is set iff one
+     * of its arcs is set in a
+     * EFFICIENCY: O(n + m/w) word operations
+     */
+    bitset_t tails(const bitset_t &a) const {
+        const bitset_t &p = pSelect->getBitset();
+        const bitset_t &q = qSelect->getBitset();
+        bitset_t v(q.size());
+        uint64_t degSum = 0;
+        for (uint64_t u = q.next(0); u != bitset_t::npos; u = q.next(u + 1)) {
+            uint64_t last = p.next(degSum);
+            if (a.count(degSum, last + 1) > 0) {
+                v[u] = 1;
+            }
+            degSum = last + 1;
+        }
+        return v;
+    }
+
+    /**
+     * @return bytes used by the p and q structures of this graph
+     */
+    virtual uint64_t byteSize() const {
+        return pSelect->byteSize() + qSelect->byteSize();
+    }
+
     virtual uint64_t phi(uint64_t u) const = 0;
 
     virtual uint64_t psi(uint64_t a) const = 0;
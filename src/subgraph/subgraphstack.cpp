@@ -1,4 +1,5 @@
 #include <sealib/collection/subgraphstack.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include "./subgraph.h"
@@ -10,52 +11,98 @@ using Sealib::BaseSubGraph;
 using Sealib::RecursiveSubGraph;
 using Sealib::SubGraphStack;
 
-std::vector<uint64_t> SubGraphStack::refs = {0, 1, 3, 15, 65535, static_cast<uint64_t>(-1)};
+SubGraphStack::ReferencePolicy SubGraphStack::tetration() {
+    return [](uint64_t r) {
+        return r < 63 ? (uint64_t(1) << (r + 1)) - 1 : INVALID;
+    };
+}
+
+SubGraphStack::ReferencePolicy SubGraphStack::geometric(uint64_t base) {
+    return [base](uint64_t r) {
+        return base == 0 || r < (INVALID - 1) / base ? r * base + 1 : INVALID;
+    };
+}
 
-SubGraphStack::SubGraphStack(std::shared_ptr<UndirectedGraph> g_) : clientList(),
-                                                               currentRef(0),
-                                                               tuned(INVALID),
-                                                               tunedPhi0(nullptr),
-                                                               tunedPsi0(nullptr),
-                                                               tunedPhi(nullptr),
-                                                               tunedPsi(nullptr) {
+SubGraphStack::SubGraphStack(std::shared_ptr<UndirectedGraph> g_,
+                             ReferencePolicy policy) : refs({0}),
+                                                       nextRef(std::move(policy)),
+                                                       clientList(),
+                                                       currentRef(0),
+                                                       budget(0),
+                                                       used(0) {
+    refs.push_back(std::max(nextRef(0), uint64_t(1)));
     clientList.emplace_back(new BaseSubGraph(this, std::move(g_)));
+    // room for two translations of each kind into G_0
+    budget = 3 * (clientList[0]->order() + clientList[0]->gMax());
 }
 
 SubGraphStack::~SubGraphStack() {
     for (SubGraph *g : clientList) {
         delete g;
     }
-    if (tunedPhi0) delete tunedPhi0;
-    if (tunedPsi0) delete tunedPsi0;
-    if (tunedPhi) delete tunedPhi;
-    if (tunedPsi) delete tunedPsi;
 }
 
 void Sealib::SubGraphStack::push(const Sealib::Bitset<uint8_t> &v,
                                  const Sealib::Bitset<uint8_t> &a) {
-    assert(currentRef+2 < SubGraphStack::refs.size());
-    if (clientList.size() - 1 == Sealib::SubGraphStack::refs[currentRef + 1]) {
-        currentRef++;
-    }
+    currentRef = reference();
     SubGraph *g = new RecursiveSubGraph(this, clientList.size(), currentRef, v, a);
     clientList.emplace_back(g);
 }
 
 void Sealib::SubGraphStack::push(Sealib::Bitset<uint8_t> &&v,
                                  Sealib::Bitset<uint8_t> &&a) {
-    assert(currentRef+2 < SubGraphStack::refs.size());
-    if (clientList.size() - 1 == Sealib::SubGraphStack::refs[currentRef + 1]) {
-        currentRef++;
-    }
+    currentRef = reference();
     SubGraph *g =
         new RecursiveSubGraph(this, clientList.size(), currentRef, std::move(v), std::move(a));
     clientList.emplace_back(g);
 }
 
+void Sealib::SubGraphStack::push(const VertexPredicate &v,
+                                 const ArcPredicate &a) {
+    currentRef = reference();
+    SubGraph *g = new RecursiveSubGraph(this, clientList.size(), currentRef, v, a);
+    clientList.emplace_back(g);
+}
+
+void Sealib::SubGraphStack::pushInduced(const VertexPredicate &v) {
+    push(v, nullptr);
+}
+
+void Sealib::SubGraphStack::pushInduced(const Sealib::Bitset<uint8_t> &v) {
+    pushInduced([&v](uint64_t u) { return v[u - 1]; });
+}
+
+uint64_t Sealib::SubGraphStack::reference() {
+    uint64_t r = currentRef;
+    if (clientList.size() - 1 == refs[r + 1]) {
+        r++;
+        if (r + 1 == refs.size()) {
+            refs.push_back(std::max(nextRef(refs[r]), refs[r] + 1));
+        }
+    }
+    return r;
+}
+
 void Sealib::SubGraphStack::pop() {
-    currentRef = clientList[clientList.size() - 1]->getRidx();
-    delete clientList[clientList.size() - 1];
+    uint64_t l = clientList.size() - 1;
+    // translations of G_l become invalid
+    for (auto it = shortcuts.begin(); it != shortcuts.end();) {
+        if ((it->first >> 33) == l) {
+            if (!it->second.pinned) used -= it->second.map->byteSize();
+            it = shortcuts.erase(it);
+        } else {
+            it++;
+        }
+    }
+    for (auto it = misses.begin(); it != misses.end();) {
+        if ((it->first >> 33) == l) {
+            it = misses.erase(it);
+        } else {
+            it++;
+        }
+    }
+    currentRef = clientList[l]->getRidx();
+    delete clientList[l];
     clientList.pop_back();
 }
 
@@ -95,19 +142,12 @@ uint64_t Sealib::SubGraphStack::phi(uint64_t i,
                                          uint64_t j,
                                          uint64_t u) const {
     if (i == j) return u;
+    return translate(i, j, u, false);
+}
 
-    /** tuned check */
-    if (i == tuned && j == 0) {
-        return tunedPhi0->select(u);
-    } else if (j == tuned && i == 0) {
-        return tunedPhi0->getBitset()[u - 1] ? tunedPhi0->rank(u) : 0;
-    } else if (i > 0 && i == tuned && j == i - 1) {
-        return tunedPhi->select(u);
-    } else if (j > 0 && j == tuned && i == j - 1) {
-        return tunedPhi->getBitset()[u - 1] ? tunedPhi->rank(u) : 0;
-    }
-    /** tuned end */
-
+uint64_t Sealib::SubGraphStack::walkPhi(uint64_t i,
+                                        uint64_t j,
+                                        uint64_t u) const {
     if (i > j) {
         uint64_t rIdx = clientList[i]->getRidx();
         uint64_t uR = clientList[i]->phi(u);
@@ -123,7 +163,7 @@ uint64_t Sealib::SubGraphStack::phi(uint64_t i,
 
         while (rIdx != clientList[j]->getRidx()) {
             rIdx++;
-            assert(rIdx < SubGraphStack::refs.size());
+            assert(rIdx < refs.size());
             uR = clientList[refs[rIdx]]->phiInv(uR);
             if (uR == 0) return 0;
         }
@@ -137,19 +177,12 @@ uint64_t Sealib::SubGraphStack::psi(uint64_t i,
     if (i == j) {
         return a;
     }
+    return translate(i, j, a, true);
+}
 
-    /** tuned check */
-    if (i == tuned && j == 0) {
-        return tunedPsi0->select(a);
-    } else if (j == tuned && i == 0) {
-        return tunedPsi0->getBitset()[a - 1] ? tunedPsi0->rank(a) : 0;
-    } else if (i > 0 && i == tuned && j == i - 1) {
-        return tunedPsi->select(a);
-    } else if (j > 0 && j == tuned && i == j - 1) {
-        return tunedPsi->getBitset()[a - 1] ? tunedPsi->rank(a) : 0;
-    }
-    /** tuned end */
-
+uint64_t Sealib::SubGraphStack::walkPsi(uint64_t i,
+                                        uint64_t j,
+                                        uint64_t a) const {
     if (i > j) {
         uint64_t rIdx = clientList[i]->getRidx();
         uint64_t uR = clientList[i]->psi(a);
@@ -165,7 +198,7 @@ uint64_t Sealib::SubGraphStack::psi(uint64_t i,
 
         while (rIdx != clientList[j]->getRidx()) {
             rIdx++;
-            assert(rIdx < SubGraphStack::refs.size());
+            assert(rIdx < refs.size());
             uR = clientList[refs[rIdx]]->psiInv(uR);
             if (uR == 0) return 0;
         }
@@ -174,24 +207,12 @@ uint64_t Sealib::SubGraphStack::psi(uint64_t i,
 }
 
 void Sealib::SubGraphStack::push(const Sealib::Bitset<uint8_t> &a) {
-    Sealib::Bitset<uint8_t> v(clientList[clientList.size() - 1]->order());
-    for (uint64_t i = 0; i < a.size(); i++) {
-        if (a[i]) {
-            uint64_t vi = std::get<0>(clientList[clientList.size() - 1]->gInv(i + 1));
-            v[vi - 1] = 1;
-        }
-    }
+    Sealib::Bitset<uint8_t> v = clientList[clientList.size() - 1]->tails(a);
     push(v, a);
 }
 
 void Sealib::SubGraphStack::push(Sealib::Bitset<uint8_t> &&a) {
-    Sealib::Bitset<uint8_t> v(clientList[clientList.size() - 1]->order());
-    for (uint64_t i = 0; i < a.size(); i++) {
-        if (a[i]) {
-            uint64_t vi = std::get<0>(clientList[clientList.size() - 1]->gInv(i + 1));
-            v[vi - 1] = 1;
-        }
-    }
+    Sealib::Bitset<uint8_t> v = clientList[clientList.size() - 1]->tails(a);
     push(std::move(v), std::move(a));
 }
 
@@ -199,47 +220,124 @@ uint64_t Sealib::SubGraphStack::gMax(uint64_t i) const {
     return clientList[i]->gMax();
 }
 
+uint64_t Sealib::SubGraphStack::translate(uint64_t i,
+                                          uint64_t j,
+                                          uint64_t x,
+                                          bool arcs) const {
+    uint64_t high = std::max(i, j), low = std::min(i, j);
+    auto it = shortcuts.find(key(high, low, arcs));
+    if (it != shortcuts.end()) {
+        Shortcut &c = it->second;
+        c.hits++;
+        if (i > j) {
+            return c.map->select(x);
+        }
+        return c.map->getBitset()[x - 1] ? c.map->rank(x) : 0;
+    }
+    uint64_t r = arcs ? walkPsi(i, j, x) : walkPhi(i, j, x);
+    uint64_t &count = misses[key(high, low, arcs)];
+    count++;
+    // building the translation costs about as much as the walks so far
+    uint64_t cost = arcs ? clientList[high]->gMax() : clientList[high]->order();
+    if (count >= std::max<uint64_t>(cost, 1)) {
+        materialize(high, low, arcs, false);
+    }
+    return r;
+}
+
+void Sealib::SubGraphStack::materialize(uint64_t high,
+                                        uint64_t low,
+                                        bool arcs,
+                                        bool pinned) const {
+    uint64_t k = key(high, low, arcs);
+    uint64_t hits = misses[k];
+    uint64_t n = arcs ? clientList[high]->gMax() : clientList[high]->order();
+    Sealib::Bitset<uint8_t> bs(arcs ? clientList[low]->gMax() : clientList[low]->order());
+    for (uint64_t x = 1; x <= n; x++) {
+        bs[(arcs ? walkPsi(high, low, x) : walkPhi(high, low, x)) - 1] = 1;
+    }
+    std::unique_ptr<RankSelect> map(new RankSelect(std::move(bs)));
+    // building costs no more than the walks that led here (see translate)
+    if (!pinned && !makeRoom(map->byteSize(), hits)) {
+        misses[k] = 0;
+        return;
+    }
+    misses.erase(k);
+    if (!pinned) used += map->byteSize();
+    shortcuts[k] = Shortcut{pinned, hits, std::move(map)};
+}
+
+bool Sealib::SubGraphStack::makeRoom(uint64_t size, uint64_t hits) const {
+    if (size > budget) {
+        return false;
+    }
+    // drop translations that were used less
+    while (used + size > budget) {
+        auto coldest = shortcuts.end();
+        for (auto it = shortcuts.begin(); it != shortcuts.end(); it++) {
+            Shortcut const &c = it->second;
+            if (!c.pinned && c.hits < hits &&
+                (coldest == shortcuts.end() || c.hits < coldest->second.hits)) {
+                coldest = it;
+            }
+        }
+        if (coldest == shortcuts.end()) {
+            return false;
+        }
+        used -= coldest->second.map->byteSize();
+        shortcuts.erase(coldest);
+    }
+    return true;
+}
+
 void Sealib::SubGraphStack::tune(uint64_t i) {
+    for (auto it = shortcuts.begin(); it != shortcuts.end();) {
+        if (it->second.pinned) {
+            it = shortcuts.erase(it);
+        } else {
+            it++;
+        }
+    }
     if (i == 0)
         return;  // G_0 is always tuned
-    tunephi0(i);
-    tunepsi0(i);
-    tunephi(i);
-    tunepsi(i);
-}
-
-void Sealib::SubGraphStack::tunephi0(uint64_t i) {
-    Sealib::Bitset<uint8_t> phi0bs(clientList[0]->order());
-    for (uint64_t u = 1; u <= clientList[i]->order(); u++) {
-        phi0bs[phi(i, u) - 1] = 1;
+    for (uint64_t j : {static_cast<uint64_t>(0), i - 1}) {
+        for (bool arcs : {false, true}) {
+            auto it = shortcuts.find(key(i, j, arcs));
+            if (it == shortcuts.end()) {
+                materialize(i, j, arcs, true);
+            } else if (!it->second.pinned) {
+                // no longer counts against the budget
+                it->second.pinned = true;
+                used -= it->second.map->byteSize();
+            }
+        }
     }
-    if (tunedPhi0) delete tunedPhi0;
-    tunedPhi0 = new RankSelect(std::move(phi0bs));
 }
 
-void Sealib::SubGraphStack::tunepsi0(uint64_t i) {
-    Sealib::Bitset<uint8_t> psi0bs(clientList[0]->gMax());
-    for (uint64_t u = 1; u <= clientList[i]->gMax(); u++) {
-        psi0bs[psi(i, u) - 1] = 1;
+void Sealib::SubGraphStack::setTuningBudget(uint64_t bytes) {
+    budget = bytes;
+    for (auto it = shortcuts.begin(); it != shortcuts.end() && used > budget;) {
+        if (!it->second.pinned) {
+            used -= it->second.map->byteSize();
+            it = shortcuts.erase(it);
+        } else {
+            it++;
+        }
     }
-    if (tunedPsi0) delete tunedPsi0;
-    tunedPsi0 = new RankSelect(std::move(psi0bs));
 }
 
-void Sealib::SubGraphStack::tunephi(uint64_t i) {
-    Sealib::Bitset<uint8_t> phibs(clientList[i - 1]->order());
-    for (uint64_t u = 1; u <= clientList[i]->order(); u++) {
-        phibs[phi(i, i - 1, u) - 1] = 1;
+uint64_t Sealib::SubGraphStack::tuningByteSize() const {
+    uint64_t r = 0;
+    for (auto const &c : shortcuts) {
+        r += c.second.map->byteSize();
     }
-    if (tunedPhi) delete tunedPhi;
-    tunedPhi = new RankSelect(std::move(phibs));
+    return r;
 }
 
-void Sealib::SubGraphStack::tunepsi(uint64_t i) {
-    Sealib::Bitset<uint8_t> psibs(clientList[i - 1]->gMax());
-    for (uint64_t u = 1; u <= clientList[i]->gMax(); u++) {
-        psibs[psi(i, i - 1, u) - 1] = 1;
+uint64_t Sealib::SubGraphStack::byteSize() const {
+    uint64_t r = tuningByteSize() + refs.capacity() * sizeof(uint64_t);
+    for (SubGraph *g : clientList) {
+        r += g->byteSize();
     }
-    if (tunedPsi) delete tunedPsi;
-    tunedPsi = new RankSelect(std::move(psibs));
+    return r;
 }
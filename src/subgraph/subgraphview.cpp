@@ -0,0 +1,25 @@
+#include "sealib/graph/subgraphview.h"
+#include <tuple>
+
+namespace Sealib {
+
+SubGraphView::SubGraphView(SubGraphStack const &stack, uint64_t i)
+    : UndirectedGraph(static_cast<uint64_t>(0)),
+      stack(stack),
+      i(i),
+      n(stack.order(i)) {}
+
+SubGraphView::SubGraphView(SubGraphStack const &stack)
+    : SubGraphView(stack, stack.size() - 1) {}
+
+uint64_t SubGraphView::deg(uint64_t u) const { return stack.degree(i, u + 1); }
+
+uint64_t SubGraphView::head(uint64_t u, uint64_t k) const {
+    return stack.head(i, u + 1, k + 1) - 1;
+}
+
+uint64_t SubGraphView::mate(uint64_t u, uint64_t k) const {
+    return std::get<1>(stack.mate(i, u + 1, k + 1)) - 1;
+}
+
+}  // namespace Sealib
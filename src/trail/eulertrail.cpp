@@ -1,6 +1,6 @@
 #include <sealib/iterator/eulertrail.h>
 #include "simpletrailstructure.h"
-#include "trailstructure.h"
+#include "trailstorage.h"
 
 using Sealib::EulerTrail;
 
@@ -10,8 +10,8 @@ EulerTrail<TrailStructureType>::iterator::iterator(
     eulerTrail(eulerTrail_),
     nIndex(nIndex_),
     mIndex(static_cast<uint64_t>(eulerTrail.trailStarts.select(nIndex) - 1)),
-    arc(mIndex > eulerTrail.trail.size() ?
-        INVALID : eulerTrail.trail[mIndex].getStartingArc()),
+    arc(mIndex > eulerTrail.graph->getOrder() ?
+        INVALID : eulerTrail.trail->getStartingArc(mIndex)),
     ending(false) {
 }
 
@@ -24,9 +24,9 @@ template<class TrailStructureType>
 typename EulerTrail<TrailStructureType>::iterator
 &EulerTrail<TrailStructureType>::iterator::operator++() {
     if (arc != INVALID) {
-        uint64_t uCross = eulerTrail.graph->getNode(mIndex).getAdj()[arc].second;
-        mIndex = eulerTrail.graph->getNode(mIndex).getAdj()[arc].first;
-        arc = eulerTrail.trail[mIndex].getMatched(uCross);
+        uint64_t uCross = eulerTrail.graph->mate(mIndex, arc);
+        mIndex = eulerTrail.graph->head(mIndex, arc);
+        arc = eulerTrail.trail->getMatched(mIndex, uCross);
         if (arc == uCross) {
             arc = INVALID;
             ending = true;
@@ -36,8 +36,8 @@ typename EulerTrail<TrailStructureType>::iterator
     } else {
         ending = false;
         mIndex = static_cast<uint64_t>(eulerTrail.trailStarts.select(++nIndex)) - 1;
-        arc = mIndex > eulerTrail.trail.size() ?
-              INVALID : eulerTrail.trail[mIndex].getStartingArc();
+        arc = mIndex > eulerTrail.graph->getOrder() ?
+              INVALID : eulerTrail.trail->getStartingArc(mIndex);
     }
     return *this;
 }
@@ -71,75 +71,44 @@ EulerTrail<TrailStructureType>::EulerTrail(const std::shared_ptr<Sealib::Undirec
 }
 
 template<class TrailStructureType>
-uint64_t EulerTrail<TrailStructureType>::findStartingNode() {
-    uint64_t order = graph->getOrder();
-
-    for (uint64_t i = 0; i < order; i++) {
-        bool isEven = trail.at(i).isEven();
-        bool isBlack = trail.at(i).isBlack();
-        if (!isEven && !isBlack) {  // odd
-            return i;
-        }
-    }
-    // no odd found, search for grey
-    for (uint64_t i = 0; i < order; i++) {
-        // first that has edges, it's possible to have a graph with no edges
-        if (trail.at(i).isGrey()
-            && !trail.at(i).isBlack()) {
-            return i;
-        }
-    }
-    // no odd found and no grey found, search for white
-    for (uint64_t i = 0; i < order; i++) {
-        // first that has edges, it's possible to have a graph with no edges
-        if (!trail.at(i).isBlack()) {
-            return i;
-        }
-    }
-    return INVALID;
-}
+EulerTrail<TrailStructureType>::~EulerTrail() = default;
 
 template<class TrailStructureType>
-std::vector<TrailStructureType>
+std::unique_ptr<Sealib::TrailStorage<TrailStructureType>>
 EulerTrail<TrailStructureType>::initializeTrail() {
-    std::vector<TrailStructureType> trail_;
-
-    uint64_t order = graph->getOrder();
-    trail_.reserve(order);
-    for (uint64_t i = 0; i < graph->getOrder(); i++) {
-        trail_.emplace_back(graph->getNode(i).getDegree());
-    }
-    trail_.shrink_to_fit();
+    std::unique_ptr<TrailStorage<TrailStructureType>> trail_(
+        new TrailStorage<TrailStructureType>(*graph));
 
-    uint64_t u = findStartingNode();
+    uint64_t u = trail_->findStartingNode();
     while (u != INVALID) {  // loop the iteration while there is a non-black vertex
         auto kOld = INVALID;
-        if (trail_.at(u).isEven() && trail_.at(u).isGrey()) {  // remember aOld
-            kOld = trail_.at(u).getLastClosed();
+        if (trail_->isEven(u) && trail_->isGrey(u)) {  // remember aOld
+            kOld = trail_->getLastClosed(u);
         }
-        uint64_t kFirst = trail_.at(u).leave();
+        uint64_t kFirst = trail_->leave(u);
 
         uint64_t k = kFirst;
         uint64_t uMate;
         do {
-            uMate = graph->getNode(u).getAdj()[k].second;
-            u = graph->getNode(u).getAdj()[k].first;  // next node
-            k = trail_.at(u).enter(uMate);
+            uMate = graph->mate(u, k);
+            u = graph->head(u, k);  // next node
+            k = trail_->enter(u, uMate);
         } while (k != INVALID);
 
         if (kOld != INVALID) {
             uint64_t kLast = uMate;
-            uint64_t kOldMatch = trail_.at(u).getMatched(kOld);
+            uint64_t kOldMatch = trail_->getMatched(u, kOld);
             if (kOldMatch != kOld) {  // has match
-                trail_.at(u).marry(kOldMatch, kFirst);
-                trail_.at(u).marry(kLast, kOld);
+                trail_->marry(u, kOldMatch, kFirst);
+                trail_->marry(u, kLast, kOld);
             } else {
-                trail_.at(u).marry(kLast, kOld);
+                trail_->marry(u, kLast, kOld);
             }
         }
         // find next start node
-        u = findStartingNode();
+        u = trail_->findStartingNode();
     }
+    trail_->finish();
     return trail_;
 }
 
@@ -148,9 +117,9 @@ Sealib::Bitset<uint8_t>
 EulerTrail<TrailStructureType>::findTrailStarts() {
     Sealib::Bitset<uint8_t> bs(graph->getOrder());
     for (uint64_t i = 0; i < graph->getOrder(); i++) {
-        bool hasStarting = trail.at(i).hasStartingArc();
+        bool hasStarting = trail->hasStartingArc(i);
         if (hasStarting) {
-            uint64_t arc = trail.at(i).getStartingArc();
+            uint64_t arc = trail->getStartingArc(i);
             hasStarting = arc != INVALID;
         }
         bs[i] = hasStarting;
@@ -20,14 +20,14 @@ NaiveEulerTrail::NaiveEulerTrail(const shared_ptr<UndirectedGraph> &g) {
     uint64_t order = g->getOrder();
     std::vector<Sealib::NaiveTrailStructure *> ts;
     for (uint64_t i = 0; i < order; i++) {
-        uint64_t degree = g->getNode(i).getDegree();
+        uint64_t degree = g->deg(i);
         ts.push_back(new Sealib::NaiveTrailStructure(degree));
     }
 
     // find first start node
     uint64_t u = INVALID;
     for (uint64_t i = 0; i < order; i++) {
-        if (g->getNode(i).getDegree() % 2 != 0) {  // odd
+        if (g->deg(i) % 2 != 0) {  // odd
             u = i;
             break;
         }
@@ -35,7 +35,7 @@ NaiveEulerTrail::NaiveEulerTrail(const shared_ptr<UndirectedGraph> &g) {
     if (u == INVALID) {  // no odd found
         for (uint64_t i = 0; i < order; i++) {
             // first that has edges, it's possible to have a graph with no edges
-            if (g->getNode(i).getDegree() != 0) {
+            if (g->deg(i) != 0) {
                 u = i;
                 break;
             }
@@ -60,8 +60,8 @@ NaiveEulerTrail::NaiveEulerTrail(const shared_ptr<UndirectedGraph> &g) {
         uint64_t uMate;
         do {
             uint64_t from = u;
-            uMate = g->getNode(u).getAdj()[k].second;
-            u = g->getNode(u).getAdj()[k].first;  // next node
+            uMate = g->mate(u, k);
+            u = g->head(u, k);  // next node
             k = ts[u]->enter(uMate);
             tempTrail.addArc(std::make_tuple(from, u));
         } while (k != INVALID);
@@ -0,0 +1,440 @@
+#include "trailarena.h"
+#include <sealib/collection/staticspacestorage.h>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace Sealib {
+
+static const uint64_t WORD_SIZE = 8 * sizeof(uint64_t);
+
+// number of bits needed to store the values 0,...,x
+static uint64_t width(uint64_t x) {
+    uint64_t w = 0;
+    while (x >> w) w++;
+    return w;
+}
+
+static uint64_t popcount(uint64_t x) {
+    return static_cast<uint64_t>(__builtin_popcountll(x));
+}
+
+/**
+ * Excess of the brackets in a nibble (+1 for each '(' and -1 for each ')')
+ * and the minimum excess over its prefixes (at most 0), indexed by
+ * brackets << 4 | opening brackets. The second table reads the nibble from
+ * its top bit down, with the signs swapped.
+ */
+struct NibbleExcess {
+    int8_t total, min;
+};
+
+static std::array<std::array<NibbleExcess, 256>, 2> makeNibbleExcess() {
+    std::array<std::array<NibbleExcess, 256>, 2> r;
+    for (uint64_t backward = 0; backward < 2; backward++) {
+        for (uint64_t x = 0; x < 256; x++) {
+            int total = 0, min = 0;
+            for (uint64_t i = 0; i < 4; i++) {
+                uint64_t bit = backward ? 3 - i : i;
+                if ((x >> (4 + bit)) & 1) {
+                    bool open = (x >> bit) & 1;
+                    total += open != static_cast<bool>(backward) ? 1 : -1;
+                    min = std::min(min, total);
+                }
+            }
+            r[backward][x] = {static_cast<int8_t>(total),
+                              static_cast<int8_t>(min)};
+        }
+    }
+    return r;
+}
+
+static std::array<std::array<NibbleExcess, 256>, 2> const nibbleExcess =
+    makeNibbleExcess();
+
+static std::vector<bool> arcPattern(UndirectedGraph const &g) {
+    std::vector<uint64_t> sizes(g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        sizes[u] = g.deg(u);
+    }
+    return StaticSpaceStorage::makeBitVector(sizes);
+}
+
+static uint64_t arcCount(UndirectedGraph const &g) {
+    uint64_t r = 0;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        r += g.deg(u);
+    }
+    return r;
+}
+
+static uint64_t maxDegree(UndirectedGraph const &g) {
+    uint64_t r = 0;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        r = std::max(r, g.deg(u));
+    }
+    return r;
+}
+
+TrailArena::TrailArena(UndirectedGraph const &g)
+    : n(g.getOrder()),
+      arcs(arcCount(g)),
+      offsets(Bitset<uint8_t>(arcPattern(g))),
+      // a field of u takes width(deg(u)) <= deg(u)+1 bits
+      state(3 * (n + arcs) / WORD_SIZE + 2),
+      grey(n),
+      black(n),
+      even(n),
+      started(n),
+      isMarried(n),
+      oddOpen(n),
+      greyOpen(n),
+      open(n),
+      oddHint(0),
+      greyHint(0),
+      openHint(0),
+      inAndOut(arcs),
+      matched(arcs),
+      dyck(arcs),
+      unused(2 * arcs, std::max<uint64_t>(maxDegree(g) + 1, 2)) {
+    for (uint64_t u = 0; u < n; u++) {
+        Slice s = slice(u);
+        even[u] = s.degree % 2 == 0;
+        black[u] = s.degree == 0;
+        if (s.degree > 0) setState(s, CURRENT, 0);
+        updateOpen(u);
+    }
+    for (uint64_t j = 0; j < 2 * arcs; j++) {
+        unused.insert(j, 1);
+    }
+}
+
+TrailArena::Slice TrailArena::slice(uint64_t u) const {
+    uint64_t marker = offsets.select(u + 1) - 1;
+    uint64_t next = offsets.getBitset().next(marker + 1);
+    if (next == offsets.getBitset().npos) next = n + arcs;
+    return {marker, marker - u, next - marker - 1};
+}
+
+uint64_t TrailArena::getState(Slice const &s, Field f) const {
+    uint64_t w = width(s.degree);
+    if (w == 0) return INVALID;
+    uint64_t p = 3 * s.marker + f * w;
+    uint64_t i = p / WORD_SIZE, o = p % WORD_SIZE;
+    uint64_t r = state[i] >> o;
+    if (o + w > WORD_SIZE) r |= state[i + 1] << (WORD_SIZE - o);
+    return (r & ((uint64_t(1) << w) - 1)) - 1;
+}
+
+void TrailArena::setState(Slice const &s, Field f, uint64_t v) {
+    uint64_t w = width(s.degree);
+    if (w == 0) return;
+    uint64_t p = 3 * s.marker + f * w, mask = (uint64_t(1) << w) - 1;
+    uint64_t i = p / WORD_SIZE, o = p % WORD_SIZE;
+    v = (v + 1) & mask;
+    state[i] = (state[i] & ~(mask << o)) | (v << o);
+    if (o + w > WORD_SIZE) {
+        uint64_t shift = WORD_SIZE - o;
+        state[i + 1] = (state[i + 1] & ~(mask >> shift)) | (v >> shift);
+    }
+}
+
+void TrailArena::updateOpen(uint64_t u) {
+    oddOpen[u] = !even[u] && !black[u];
+    if (oddOpen[u] && u < oddHint) oddHint = u;
+    greyOpen[u] = grey[u] && !black[u];
+    if (greyOpen[u] && u < greyHint) greyHint = u;
+    open[u] = !black[u];
+}
+
+uint64_t TrailArena::findStartingNode() const {
+    uint64_t u = oddOpen.next(oddHint);
+    if (u != oddOpen.npos) return oddHint = u;
+    oddHint = n;
+    u = greyOpen.next(greyHint);
+    if (u != greyOpen.npos) return greyHint = u;
+    greyHint = n;
+    u = open.next(openHint);
+    if (u != open.npos) return openHint = u;
+    openHint = n;
+    return INVALID;
+}
+
+uint64_t TrailArena::removeUnused(Slice const &s, uint64_t idx) {
+    if (getState(s, CURRENT) == INVALID) return INVALID;
+    uint64_t b = s.begin, d = s.degree;
+    uint64_t prevDist = unused.get(2 * (b + idx)),
+             nextDist = unused.get(2 * (b + idx) + 1);
+    uint64_t prev = (idx + d - prevDist) % d;
+    if (prev == idx) {  // last element
+        setState(s, CURRENT, INVALID);
+        return idx;
+    }
+    uint64_t next = (idx + nextDist) % d;
+    unused.insert(2 * (b + prev) + 1,
+                  unused.get(2 * (b + prev) + 1) + nextDist);
+    unused.insert(2 * (b + next), unused.get(2 * (b + next)) + prevDist);
+    setState(s, CURRENT, next);
+    return next;
+}
+
+uint64_t TrailArena::getNextUnused(uint64_t u, Slice const &s) {
+    if (black[u]) return INVALID;
+    grey[u] = 1;
+    uint64_t next = getState(s, CURRENT);
+    if (removeUnused(s, next) == next) {  // no arcs left
+        black[u] = 1;
+        even[u] = 1;
+    } else {
+        even[u] = !even[u];
+    }
+    return next;
+}
+
+uint64_t TrailArena::leave(uint64_t u) {
+    Slice s = slice(u);
+    uint64_t k = getNextUnused(u, s);
+    if (k != INVALID) {
+        setState(s, LAST_CLOSED, k);
+        started[u] = 1;
+    }
+    if (black[u]) initDyckStructure(s);
+    updateOpen(u);
+    return k;
+}
+
+uint64_t TrailArena::enter(uint64_t u, uint64_t i) {
+    if (black[u]) return INVALID;
+    Slice s = slice(u);
+    uint64_t next = removeUnused(s, i);
+    inAndOut[s.begin + i] = 1;
+    even[u] = !even[u];
+    if (next == i) {  // no arcs left
+        black[u] = 1;
+        even[u] = 1;
+        initDyckStructure(s);
+        updateOpen(u);
+        return INVALID;
+    }
+    matched[s.begin + i] = 1;
+    matched[s.begin + next] = 1;
+
+    next = getNextUnused(u, s);
+    setState(s, LAST_CLOSED, next);
+    if (black[u]) initDyckStructure(s);
+    updateOpen(u);
+    return next;
+}
+
+void TrailArena::initDyckStructure(Slice const &s) {
+    uint64_t b = s.begin, d = s.degree;
+    if (d == 0) return;
+    for (uint64_t j = b; j < b + d; j++) {
+        dyck[j] = matched[j];
+    }
+    uint64_t lastClosed = getState(s, LAST_CLOSED);
+    uint64_t start = lastClosed + 1 == d ? 0 : lastClosed + 1;
+    if (matched.count(b, b + d) > 0) {
+        // start at the first opening bracket after the last one closed
+        while (!matched[b + start]) {
+            start = start == d - 1 ? 0 : start + 1;
+        }
+    }
+    setState(s, DYCK_START, start);
+}
+
+uint64_t TrailArena::dyckMatch(Slice const &s, uint64_t k) const {
+    uint64_t d = s.degree, start = getState(s, DYCK_START), opens = 0;
+    // The Dyck word consists of the arcs in dyck, read circularly from start.
+    uint64_t j = selectArc(dyck, s, start, k, &opens);
+    if (j == INVALID) return k;  // k is not part of the word
+    int64_t excess = 1;
+    uint64_t w, r;
+    if (inAndOut[s.begin + j]) {  // '(': scan forward to the closing bracket
+        w = k + 1;
+        r = closeForward(s, j + 1, j >= start ? d : start, &excess, &w);
+        if (r == INVALID && j >= start) {
+            r = closeForward(s, 0, start, &excess, &w);
+        }
+        return r == INVALID ? k : w;
+    }
+    // ')': the last '(' in front of it that opens the same depth
+    if (2 * opens == k) return k;  // depth 0
+    w = k;
+    r = openBackward(s, j >= start ? start : 0, j, &excess, &w);
+    if (r == INVALID && j < start) {
+        r = openBackward(s, start, d, &excess, &w);
+    }
+    return r == INVALID ? k : w;
+}
+
+uint64_t TrailArena::selectArc(Bitset<uint8_t> const &mask, Slice const &s,
+                               uint64_t start, uint64_t k,
+                               uint64_t *opens) const {
+    uint64_t b = s.begin;
+    // the slice in circular order: [start, degree), then [0, start)
+    for (std::pair<uint64_t, uint64_t> part :
+         {std::make_pair(start, s.degree),
+          std::make_pair(uint64_t(0), start)}) {
+        for (uint64_t p = part.first; p < part.second; p += WORD_SIZE) {
+            uint64_t len = std::min(WORD_SIZE, part.second - p);
+            uint64_t x = mask.getBits(b + p, len), o = 0;
+            if (opens != nullptr) o = inAndOut.getBits(b + p, len) & x;
+            uint64_t c = popcount(x);
+            if (c <= k) {
+                k -= c;
+                if (opens != nullptr) *opens += popcount(o);
+                continue;
+            }
+            for (; k > 0; k--) x &= x - 1;
+            uint64_t i = static_cast<uint64_t>(__builtin_ctzll(x));
+            if (opens != nullptr) {
+                *opens += popcount(o & ((uint64_t(1) << i) - 1));
+            }
+            return p + i;
+        }
+    }
+    return INVALID;
+}
+
+uint64_t TrailArena::closeForward(Slice const &s, uint64_t from, uint64_t to,
+                                  int64_t *excess, uint64_t *w) const {
+    for (uint64_t p = from; p < to; p += WORD_SIZE) {
+        uint64_t len = std::min(WORD_SIZE, to - p);
+        uint64_t x = dyck.getBits(s.begin + p, len),
+                 o = inAndOut.getBits(s.begin + p, len) & x;
+        int64_t opens = static_cast<int64_t>(popcount(o)),
+                closes = static_cast<int64_t>(popcount(x & ~o));
+        if (*excess - closes > 0) {  // cannot drop to 0 in this word
+            *excess += opens - closes;
+            *w += popcount(x);
+            continue;
+        }
+        for (uint64_t q = 0; q < len; q += 4) {
+            uint64_t xn = (x >> q) & 15, on = (o >> q) & 15;
+            NibbleExcess const &e = nibbleExcess[0][xn << 4 | on];
+            if (*excess + e.min > 0) {
+                *excess += e.total;
+                *w += popcount(xn);
+                continue;
+            }
+            for (uint64_t i = 0; i < 4; i++) {
+                if ((xn >> i) & 1) {
+                    *excess += (on >> i) & 1 ? 1 : -1;
+                    if (*excess == 0) return p + q + i;
+                    (*w)++;
+                }
+            }
+        }
+    }
+    return INVALID;
+}
+
+uint64_t TrailArena::openBackward(Slice const &s, uint64_t from, uint64_t to,
+                                  int64_t *excess, uint64_t *w) const {
+    for (uint64_t p = to; p > from;) {
+        uint64_t len = std::min(WORD_SIZE, p - from);
+        p -= len;
+        uint64_t x = dyck.getBits(s.begin + p, len),
+                 o = inAndOut.getBits(s.begin + p, len) & x;
+        int64_t opens = static_cast<int64_t>(popcount(o)),
+                closes = static_cast<int64_t>(popcount(x & ~o));
+        if (*excess - opens > 0) {  // cannot drop to 0 in this word
+            *excess += closes - opens;
+            *w -= popcount(x);
+            continue;
+        }
+        for (uint64_t q = (len + 3) / 4 * 4; q > 0;) {
+            q -= 4;
+            uint64_t xn = (x >> q) & 15, on = (o >> q) & 15;
+            NibbleExcess const &e = nibbleExcess[1][xn << 4 | on];
+            if (*excess + e.min > 0) {
+                *excess += e.total;
+                *w -= popcount(xn);
+                continue;
+            }
+            for (uint64_t i = 4; i > 0;) {
+                i--;
+                if ((xn >> i) & 1) {
+                    (*w)--;
+                    *excess += (on >> i) & 1 ? -1 : 1;
+                    if (*excess == 0) return p + q + i;
+                }
+            }
+        }
+    }
+    return INVALID;
+}
+
+uint64_t TrailArena::getMatched(uint64_t u, uint64_t idx) const {
+    return getMatched(u, slice(u), idx);
+}
+
+uint64_t TrailArena::getMatched(uint64_t u, Slice const &s,
+                                uint64_t idx) const {
+    if (isMarried[u]) {
+        std::array<uint64_t, 4> const &m = married.at(u);
+        if (m[0] == idx) return m[1];
+        if (m[1] == idx) return m[0];
+        if (m[2] == idx) return m[3];
+        if (m[3] == idx) return m[2];
+    }
+    uint64_t b = s.begin, d = s.degree;
+    if (!matched[b + idx]) return idx;  // has no match
+
+    uint64_t start = getState(s, DYCK_START);
+    uint64_t dyckIdx = idx >= start ? matched.count(b + start, b + idx)
+                                    : matched.count(b + start, b + d) +
+                                          matched.count(b, b + idx);
+    uint64_t match = dyckMatch(s, dyckIdx);
+    if (match == dyckIdx) return idx;
+
+    // the match-th matched arc after dyckStart (counting around the slice)
+    return selectArc(matched, s, start, match % matched.count(b, b + d),
+                     nullptr);
+}
+
+void TrailArena::marry(uint64_t u, uint64_t i, uint64_t o) {
+    Slice s = slice(u);
+    uint64_t b = s.begin;
+    uint64_t iMatch = getMatched(u, s, i);
+    uint64_t oMatch = getMatched(u, s, o);
+    matched[b + iMatch] = !matched[b + iMatch];
+    matched[b + i] = !matched[b + i];
+    matched[b + oMatch] = !matched[b + oMatch];
+    matched[b + o] = !matched[b + o];
+    if (!isMarried[u]) {
+        married[u] = {i, o, INVALID, INVALID};
+        isMarried[u] = 1;
+    } else {
+        married[u][2] = i;
+        married[u][3] = o;
+    }
+}
+
+uint64_t TrailArena::getStartingArc(uint64_t u) const {
+    if (!started[u]) return INVALID;
+    Slice s = slice(u);
+    for (uint64_t i = 0; i < s.degree; i++) {
+        if (!inAndOut[s.begin + i] && getMatched(u, s, i) == i) return i;
+    }
+    return INVALID;
+}
+
+void TrailArena::finish() {
+    unused = CompactArray(0, 2);
+    oddOpen = greyOpen = open = Bitset<uint8_t>();
+}
+
+uint64_t TrailArena::byteSize() const {
+    typedef std::pair<uint64_t, std::array<uint64_t, 4>> MarriedEntry;
+    return offsets.byteSize() + state.capacity() * sizeof(uint64_t) +
+           grey.byteSize() + black.byteSize() + even.byteSize() +
+           started.byteSize() + isMarried.byteSize() + oddOpen.byteSize() +
+           greyOpen.byteSize() + open.byteSize() + inAndOut.byteSize() +
+           matched.byteSize() + dyck.byteSize() + unused.byteSize() +
+           married.size() * sizeof(MarriedEntry);
+}
+
+}  // namespace Sealib
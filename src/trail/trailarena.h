@@ -0,0 +1,139 @@
+#ifndef SRC_TRAIL_TRAILARENA_H_
+#define SRC_TRAIL_TRAILARENA_H_
+
+#include <sealib/collection/bitset.h>
+#include <sealib/collection/compactarray.h>
+#include <sealib/dictionary/rankselect.h>
+#include <sealib/graph/undirectedgraph.h>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace Sealib {
+/**
+ * The trail structures of all vertices of a graph, stored in a few flat
+ * arrays instead of one object (and several heap blocks) per vertex.
+ * The arcs of vertex u own a slice of deg(u) consecutive bits in the arc
+ * bitsets; the slices are located with a rank-select index over the bit
+ * pattern 1 0^deg(0) 1 0^deg(1) ..., as in a StaticSpaceStorage. The same
+ * index places the state of u (3 fields of log(deg(u)) bits) in a bit array.
+ * Each method behaves like the method of TrailStructure with the same name,
+ * called on the trail structure of u. The Dyck word of a black vertex is kept
+ * as a mask over its slice, and brackets are matched by scanning it a word at
+ * a time: a table of the excess of each nibble skips the parts where the depth
+ * cannot return to that of the bracket.
+ * EFFICIENCY: O(n + m) bits after finish(), O(m log(maxdeg)) bits before
+ */
+class TrailArena {
+ public:
+    /**
+     * Create the trail structures for all vertices of g.
+     * @param g the graph
+     */
+    explicit TrailArena(UndirectedGraph const &g);
+
+    bool isGrey(uint64_t u) const { return grey[u]; }
+
+    bool isBlack(uint64_t u) const { return black[u]; }
+
+    bool isEven(uint64_t u) const { return even[u]; }
+
+    uint64_t getLastClosed(uint64_t u) const {
+        return getState(slice(u), LAST_CLOSED);
+    }
+
+    uint64_t leave(uint64_t u);
+
+    uint64_t enter(uint64_t u, uint64_t i);
+
+    void marry(uint64_t u, uint64_t i, uint64_t o);
+
+    uint64_t getMatched(uint64_t u, uint64_t idx) const;
+
+    uint64_t getStartingArc(uint64_t u) const;
+
+    bool hasStartingArc(uint64_t u) const { return started[u]; }
+
+    /**
+     * Find the vertex where the next trail starts: the first odd vertex that
+     * is not black, otherwise the first grey one, otherwise the first white
+     * one. The flags are scanned a word at a time.
+     * @return the vertex, or INVALID if all vertices are black
+     */
+    uint64_t findStartingNode() const;
+
+    /**
+     * Release the data that is only needed while the trails are built (the
+     * lists of unused arcs).
+     */
+    void finish();
+
+    uint64_t byteSize() const;
+
+ private:
+    enum Field { LAST_CLOSED, DYCK_START, CURRENT };
+
+    /**
+     * Position of a vertex in the arena: its arcs are [begin, begin+degree),
+     * and its state fields start at bit 3*marker of the state array, where
+     * marker is the position of the vertex in the offset pattern.
+     */
+    struct Slice {
+        uint64_t marker, begin, degree;
+    };
+
+    uint64_t n, arcs;
+    RankSelect offsets;
+    // lastClosed, dyckStart and the current unused arc of each vertex,
+    // stored as value+1 (0 stands for INVALID)
+    std::vector<uint64_t> state;
+    Bitset<uint8_t> grey, black, even, started, isMarried;
+    // vertices that findStartingNode() looks for, with a lower bound for the
+    // first set bit of each
+    Bitset<uint8_t> oddOpen, greyOpen, open;
+    mutable uint64_t oddHint, greyHint, openHint;
+    Bitset<uint8_t> inAndOut, matched, dyck;
+    // distances to the previous and next unused arc, two entries per arc
+    CompactArray unused;
+    std::unordered_map<uint64_t, std::array<uint64_t, 4>> married;
+
+    Slice slice(uint64_t u) const;
+    uint64_t getState(Slice const &s, Field f) const;
+    void setState(Slice const &s, Field f, uint64_t v);
+
+    uint64_t getNextUnused(uint64_t u, Slice const &s);
+    uint64_t removeUnused(Slice const &s, uint64_t idx);
+    void initDyckStructure(Slice const &s);
+    uint64_t getMatched(uint64_t u, Slice const &s, uint64_t idx) const;
+    /**
+     * Match bracket k of the Dyck word of a black vertex.
+     * @return index of the matching bracket, k if there is none
+     */
+    uint64_t dyckMatch(Slice const &s, uint64_t k) const;
+    /**
+     * Find the k-th set bit of mask in the slice, read circularly from start.
+     * @param opens if not nullptr, the number of opening brackets in front of
+     * it is added to *opens
+     * @return its position in the slice, INVALID if there are at most k
+     */
+    uint64_t selectArc(Bitset<uint8_t> const &mask, Slice const &s,
+                       uint64_t start, uint64_t k, uint64_t *opens) const;
+    /**
+     * Scan the brackets at positions [from, to) of the slice forward (or
+     * backward) for the first one after which the excess in *excess drops to
+     * 0. A '(' adds 1 to the excess when it is read forward and subtracts 1
+     * when it is read backward.
+     * @param excess excess in front of the range (> 0), updated
+     * @param w number of brackets in front of the point where the scan
+     * starts (from, or to when scanning backward), updated: on success, the
+     * index of the bracket found
+     * @return position of the bracket found, INVALID if there is none
+     */
+    uint64_t closeForward(Slice const &s, uint64_t from, uint64_t to,
+                          int64_t *excess, uint64_t *w) const;
+    uint64_t openBackward(Slice const &s, uint64_t from, uint64_t to,
+                          int64_t *excess, uint64_t *w) const;
+    void updateOpen(uint64_t u);
+};
+}  // namespace Sealib
+#endif  // SRC_TRAIL_TRAILARENA_H_
@@ -0,0 +1,85 @@
+#ifndef SRC_TRAIL_TRAILSTORAGE_H_
+#define SRC_TRAIL_TRAILSTORAGE_H_
+
+#include <sealib/graph/undirectedgraph.h>
+#include <vector>
+#include "trailarena.h"
+#include "trailstructure.h"
+
+namespace Sealib {
+/**
+ * The trail structures of all vertices of a graph, addressed by vertex.
+ * By default, every vertex gets its own object of type T.
+ * @tparam T trail structure type
+ */
+template <class T>
+class TrailStorage {
+ public:
+    explicit TrailStorage(UndirectedGraph const &g) {
+        trail.reserve(g.getOrder());
+        for (uint64_t u = 0; u < g.getOrder(); u++) {
+            trail.emplace_back(g.deg(u));
+        }
+    }
+
+    bool isGrey(uint64_t u) const { return trail[u].isGrey(); }
+
+    bool isBlack(uint64_t u) const { return trail[u].isBlack(); }
+
+    bool isEven(uint64_t u) const { return trail[u].isEven(); }
+
+    uint64_t getLastClosed(uint64_t u) const {
+        return trail[u].getLastClosed();
+    }
+
+    uint64_t leave(uint64_t u) { return trail[u].leave(); }
+
+    uint64_t enter(uint64_t u, uint64_t i) { return trail[u].enter(i); }
+
+    void marry(uint64_t u, uint64_t i, uint64_t o) { trail[u].marry(i, o); }
+
+    uint64_t getMatched(uint64_t u, uint64_t idx) const {
+        return trail[u].getMatched(idx);
+    }
+
+    uint64_t getStartingArc(uint64_t u) const {
+        return trail[u].getStartingArc();
+    }
+
+    bool hasStartingArc(uint64_t u) const {
+        return trail[u].hasStartingArc();
+    }
+
+    /**
+     * @return the first odd vertex that is not black, otherwise the first
+     * grey one, otherwise the first white one, INVALID if all are black
+     */
+    uint64_t findStartingNode() const {
+        for (uint64_t u = 0; u < trail.size(); u++) {
+            if (!trail[u].isEven() && !trail[u].isBlack()) return u;
+        }
+        for (uint64_t u = 0; u < trail.size(); u++) {
+            if (trail[u].isGrey() && !trail[u].isBlack()) return u;
+        }
+        for (uint64_t u = 0; u < trail.size(); u++) {
+            if (!trail[u].isBlack()) return u;
+        }
+        return INVALID;
+    }
+
+    void finish() {}
+
+ private:
+    std::vector<T> trail;
+};
+
+/**
+ * TrailStructures are kept in a single arena for the whole graph.
+ */
+template <>
+class TrailStorage<TrailStructure> : public TrailArena {
+ public:
+    explicit TrailStorage(UndirectedGraph const &g) : TrailArena(g) {}
+};
+}  // namespace Sealib
+#endif  // SRC_TRAIL_TRAILSTORAGE_H_
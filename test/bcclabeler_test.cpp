@@ -0,0 +1,133 @@
+#include "sealib/iterator/bcclabeler.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stack>
+#include <utility>
+#include <vector>
+#include "sealib/graph/graphcreator.h"
+
+using namespace Sealib;  // NOLINT
+
+typedef std::pair<uint64_t, uint64_t> Edge;
+
+static Edge edge(uint64_t u, uint64_t v) {
+    return {std::min(u, v), std::max(u, v)};
+}
+
+/**
+ * @return the end (u,k) of an edge that is used as its key (the graphs may
+ * have parallel edges)
+ */
+static Edge key(UndirectedGraph const &g, uint64_t u, uint64_t k) {
+    return std::min(Edge(u, k), Edge(g.head(u, k), g.mate(u, k)));
+}
+
+/**
+ * @return the BCC number of each edge key (Hopcroft-Tarjan with an edge
+ * stack)
+ */
+static std::map<Edge, uint64_t> referenceBCCs(UndirectedGraph const &g) {
+    uint64_t n = g.getOrder(), time = 0, count = 0;
+    std::vector<uint64_t> pre(n, INVALID), low(n), parent(n, INVALID);
+    std::map<Edge, uint64_t> r;
+    std::vector<Edge> edges;  // keys of the edges
+    for (uint64_t a = 0; a < n; a++) {
+        if (pre[a] != INVALID) continue;
+        std::stack<std::pair<uint64_t, uint64_t>> s;
+        s.push({a, 0});
+        pre[a] = low[a] = time++;
+        while (!s.empty()) {
+            uint64_t u = s.top().first, k = s.top().second++;
+            if (k < g.deg(u)) {
+                uint64_t v = g.head(u, k);
+                if (k == parent[u] || u == v) continue;
+                if (pre[v] == INVALID) {
+                    edges.push_back(key(g, u, k));
+                    pre[v] = low[v] = time++;
+                    parent[v] = g.mate(u, k);
+                    s.push({v, 0});
+                } else if (pre[v] < pre[u]) {
+                    edges.push_back(key(g, u, k));
+                    low[u] = std::min(low[u], pre[v]);
+                }
+            } else {
+                s.pop();
+                if (s.empty()) continue;
+                uint64_t w = s.top().first;
+                low[w] = std::min(low[w], low[u]);
+                if (low[u] >= pre[w]) {
+                    // w separates the edges above {w,u} from the BCC
+                    Edge top = key(g, u, parent[u]), x;
+                    do {
+                        x = edges.back();
+                        edges.pop_back();
+                        r[x] = count;
+                    } while (x != top);
+                    count++;
+                }
+            }
+        }
+    }
+    return r;
+}
+
+static void checkLabels(UndirectedGraph const &g) {
+    std::map<Edge, uint64_t> expected = referenceBCCs(g);
+    BCCLabeler l(g);
+    std::vector<bool> done;
+    std::map<Edge, std::multiset<uint64_t>> streamed;
+    uint64_t edges = 0;
+    l.init(
+        [&](uint64_t id, uint64_t u, uint64_t v) {
+            ASSERT_LT(id, l.getCount());
+            if (done.size() <= id) done.resize(id + 1);
+            EXPECT_FALSE(done[id]);
+            streamed[edge(u, v)].insert(id);
+            edges++;
+        },
+        [&](uint64_t id) {
+            ASSERT_LT(id, done.size());
+            EXPECT_FALSE(done[id]);
+            done[id] = true;
+        });
+    EXPECT_EQ(edges, expected.size());
+    EXPECT_EQ(std::count(done.begin(), done.end(), true), l.getCount());
+
+    // the same partition of the edges, up to the numbering of the BCCs
+    std::map<uint64_t, uint64_t> map, inverse;
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            uint64_t v = g.head(u, k), id = l.getComponent(u, k);
+            if (u == v) {
+                EXPECT_EQ(id, INVALID);
+                continue;
+            }
+            if (key(g, u, k) == Edge(u, k)) {
+                // every edge was passed to onEdge with its id
+                std::multiset<uint64_t> &ids = streamed[edge(u, v)];
+                ASSERT_NE(ids.find(id), ids.end());
+                ids.erase(ids.find(id));
+            }
+            uint64_t b = expected.at(key(g, u, k));
+            EXPECT_EQ(map.emplace(id, b).first->second, b);
+            EXPECT_EQ(inverse.emplace(b, id).first->second, id);
+        }
+    }
+}
+
+TEST(BCCLabelerTest, windmill) {
+    UndirectedGraph g = GraphCreator::windmill(5, 8);
+    BCCLabeler l(g);
+    l.init();
+    EXPECT_EQ(l.getCount(), 8);
+    checkLabels(g);
+}
+
+TEST(BCCLabelerTest, random) {
+    for (uint64_t k = 1; k <= 4; k++) {
+        checkLabels(GraphCreator::kRegular(3000, k));
+    }
+    checkLabels(GraphCreator::sparseUndirected(3000));
+}
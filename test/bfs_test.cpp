@@ -65,3 +65,59 @@ TEST(SimpleBFSTest, nextComponent) {
     EXPECT_EQ(c1, ORDER);
     EXPECT_EQ(c2, 0);
 }
+
+// Check the compact distance array against the distances of the iterator
+TEST(BFSTest, distances) {
+    UndirectedGraph g = GraphCreator::kRegular(ORDER, 4);
+    std::vector<uint64_t> d(g.getOrder());
+    SimpleBFS b(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b.init();
+    b.forEach([&d](std::pair<uint64_t, uint64_t> p) { d[p.first] = p.second; });
+    CompactArray c = BFS::distances(g);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        EXPECT_EQ(c.get(u), d[u]);
+    }
+    EXPECT_LT(c.byteSize(), g.getOrder());
+}
+
+// Check that the parent arcs form a BFS tree
+TEST(BFSTest, parents) {
+    UndirectedGraph g = GraphCreator::kRegular(ORDER, 4);
+    CompactArray d = BFS::distances(g);
+    StaticSpaceStorage p = BFS::parents(g);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        if (p.get(u) == g.deg(u)) {
+            EXPECT_EQ(d.get(u), 0);
+        } else {
+            EXPECT_EQ(d.get(g.head(u, p.get(u))) + 1, d.get(u));
+        }
+    }
+}
+
+// Check the bidirectional search against the distances of a full BFS
+TEST(BFSTest, distance) {
+    UndirectedGraph g = GraphCreator::kRegular(ORDER, 4);
+    CompactArray d = BFS::distances(g);
+    for (uint64_t t = 0; t < g.getOrder(); t += 97) {
+        EXPECT_EQ(BFS::distance(g, 0, t), d.get(t));
+        EXPECT_EQ(BFS::distance(g, t, 0), d.get(t));
+    }
+    UndirectedGraph c = GraphCreator::cycle(ORDER);
+    uint64_t touched = 0;
+    EXPECT_EQ(BFS::distance(c, 10, 20, &touched), 10);
+    EXPECT_LT(touched, 30);
+    UndirectedGraph e(10);
+    EXPECT_EQ(BFS::distance(e, 1, 2), INVALID);
+    EXPECT_EQ(BFS::distance(e, 3, 3), 0);
+}
+
+TEST(BFSTest, range) {
+    DirectedGraph g = GraphCreator::kOutdegree(ORDER, 1);
+    std::vector<std::pair<uint64_t, uint64_t>> v1, v2;
+    BFS b1(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    b1.forEach([&v1](std::pair<uint64_t, uint64_t> p) { v1.push_back(p); });
+    BFS b2(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE);
+    for (std::pair<uint64_t, uint64_t> p : iterate(b2)) v2.push_back(p);
+    EXPECT_EQ(v1.size(), ORDER);
+    EXPECT_EQ(v1, v2);
+}
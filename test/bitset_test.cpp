@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <sealib/collection/bitset.h>
+#include <random>
 
 using Sealib::Bitset;
 
@@ -300,3 +301,81 @@ TEST(BitsetTest, operators) {
     EXPECT_EQ(c[10] & c[20], 1);
     EXPECT_EQ(c[5], 0);
 }
+
+TEST(BitsetTest, countAndNext) {
+    Bitset<uint8_t> b(300);
+    Bitset<uint64_t> c(300);
+    const uint64_t npos = Bitset<uint8_t>::npos;
+    for (uint64_t i = 0; i < b.size(); i++) {
+        if (i % 7 == 0 || (i > 100 && i < 170)) {
+            b[i] = 1;
+            c[i] = 1;
+        }
+    }
+    for (uint64_t from = 0; from <= b.size(); from += 13) {
+        for (uint64_t to = from; to <= b.size(); to += 11) {
+            uint64_t expected = 0;
+            for (uint64_t i = from; i < to; i++) {
+                expected += b[i];
+            }
+            EXPECT_EQ(b.count(from, to), expected);
+            EXPECT_EQ(c.count(from, to), expected);
+        }
+        uint64_t expected = from;
+        while (expected < b.size() && !b[expected]) {
+            expected++;
+        }
+        if (expected == b.size()) {
+            expected = npos;
+        }
+        EXPECT_EQ(b.next(from), expected);
+        EXPECT_EQ(c.next(from), expected);
+    }
+    Bitset<uint8_t> d(20);
+    d.set();
+    EXPECT_EQ(d.count(0, 20), 20);
+    EXPECT_EQ(d.next(19), 19);
+    EXPECT_EQ(d.next(20), npos);
+}
+
+TEST(BitsetTest, getBits) {
+    Bitset<uint8_t> b(300);
+    Bitset<uint64_t> c(300);
+    for (uint64_t i = 0; i < b.size(); i++) {
+        if (i % 3 == 0 || i % 5 == 0) {
+            b[i] = 1;
+            c[i] = 1;
+        }
+    }
+    for (uint64_t from = 0; from < b.size(); from += 7) {
+        for (uint64_t len = 0; len <= 64 && from + len <= b.size(); len += 8) {
+            uint64_t expected = 0;
+            for (uint64_t i = 0; i < len; i++) {
+                expected |= uint64_t(b[from + i]) << i;
+            }
+            EXPECT_EQ(b.getBits(from, len), expected);
+            EXPECT_EQ(c.getBits(from, len), expected);
+        }
+    }
+}
+
+TEST(BitsetTest, setBits) {
+    Bitset<uint8_t> b(300);
+    Bitset<uint64_t> c(300);
+    std::mt19937_64 r(7);
+    for (uint64_t from = 0; from < b.size(); from += 7) {
+        for (uint64_t len = 0; len <= 64 && from + len <= b.size(); len += 8) {
+            uint64_t x = r();
+            Bitset<uint8_t> expected = b;
+            for (uint64_t i = 0; i < len; i++) {
+                expected[from + i] = (x >> i) & 1;
+            }
+            b.setBits(from, len, x);
+            c.setBits(from, len, x);
+            for (uint64_t i = 0; i < b.size(); i++) {
+                ASSERT_EQ(b.get(i), expected.get(i));
+                ASSERT_EQ(c.get(i), expected.get(i));
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "sealib/iterator/blockcuttree.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <vector>
+#include "sealib/graph/graphcreator.h"
+#include "sealib/iterator/cutvertexiterator.h"
+
+using namespace Sealib;  // NOLINT
+
+/**
+ * @return the blocks of each vertex (the labels of its edges)
+ */
+static std::vector<std::set<uint64_t>> vertexBlocks(UndirectedGraph const &g,
+                                                    BCCLabeler const &l) {
+    std::vector<std::set<uint64_t>> r(g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            if (g.head(u, k) != u) r[u].insert(l.getComponent(u, k));
+        }
+    }
+    return r;
+}
+
+/**
+ * @return the blocks on the path from u to v in an explicit block-cut tree
+ * (nodes: blocks, then vertices)
+ */
+static std::vector<uint64_t> referencePath(
+    std::vector<std::set<uint64_t>> const &blocks, uint64_t b, uint64_t u,
+    uint64_t v) {
+    uint64_t n = blocks.size();
+    std::vector<std::vector<uint64_t>> adj(b + n);
+    for (uint64_t w = 0; w < n; w++) {
+        if (blocks[w].size() < 2) continue;
+        for (uint64_t x : blocks[w]) {
+            adj[x].push_back(b + w);
+            adj[b + w].push_back(x);
+        }
+    }
+    auto node = [&](uint64_t w) {
+        return blocks[w].size() == 1 ? *blocks[w].begin() : b + w;
+    };
+    uint64_t x = node(u), y = node(v);
+    std::vector<uint64_t> from(b + n, INVALID);
+    std::queue<uint64_t> q;
+    q.push(y);
+    from[y] = y;
+    while (!q.empty()) {
+        uint64_t z = q.front();
+        q.pop();
+        for (uint64_t w : adj[z]) {
+            if (from[w] == INVALID) {
+                from[w] = z;
+                q.push(w);
+            }
+        }
+    }
+    std::vector<uint64_t> r;
+    if (from[x] == INVALID) return r;
+    for (; x != y; x = from[x]) {
+        if (x < b) r.push_back(x);
+    }
+    if (y < b) r.push_back(y);
+    return r;
+}
+
+static void checkTree(UndirectedGraph const &g) {
+    BlockCutTree t(g);
+    std::vector<std::set<uint64_t>> blocks = vertexBlocks(g, t.getLabeler());
+    uint64_t n = g.getOrder(), cuts = 0;
+    for (uint64_t u = 0; u < n; u++) {
+        EXPECT_EQ(t.isCutVertex(u), blocks[u].size() > 1);
+        if (t.isCutVertex(u)) {
+            EXPECT_EQ(t.getNode(u), t.getBlockCount() + cuts++);
+        }
+        std::set<uint64_t> actual;
+        t.forEachBlock(u, [&](uint64_t x) {
+            EXPECT_TRUE(actual.insert(x).second);
+        });
+        EXPECT_EQ(actual, blocks[u]);
+        EXPECT_EQ(t.sameBlock(u, u), !blocks[u].empty());
+    }
+    EXPECT_EQ(t.getCutVertexCount(), cuts);
+
+    // the parent of every node is a neighbour in the block-cut tree
+    for (uint64_t x = 0; x < t.getBlockCount() + cuts; x++) {
+        uint64_t p = t.getParent(x);
+        if (p == INVALID) continue;
+        uint64_t block = x < p ? x : p, node = x < p ? p : x;
+        ASSERT_LT(block, t.getBlockCount());
+        ASSERT_GE(node, t.getBlockCount());
+        uint64_t u = 0;
+        while (!t.isCutVertex(u) || t.getNode(u) != node) u++;
+        EXPECT_EQ(blocks[u].count(block), 1);
+    }
+
+    for (uint64_t u = 0; u < n; u += 7) {
+        for (uint64_t v = 0; v < n; v += 13) {
+            std::vector<uint64_t> common;
+            std::set_intersection(blocks[u].begin(), blocks[u].end(),
+                                  blocks[v].begin(), blocks[v].end(),
+                                  std::back_inserter(common));
+            EXPECT_EQ(t.sameBlock(u, v), !common.empty());
+            if (blocks[u].empty() || blocks[v].empty()) {
+                EXPECT_TRUE(t.blockPath(u, v).empty());
+            } else {
+                EXPECT_EQ(t.blockPath(u, v),
+                          referencePath(blocks, t.getBlockCount(), u, v));
+            }
+        }
+    }
+}
+
+TEST(BlockCutTreeTest, windmill) {
+    UndirectedGraph g = GraphCreator::windmill(4, 6);
+    BlockCutTree t(g);
+    EXPECT_EQ(t.getBlockCount(), 6);
+    EXPECT_EQ(t.getCutVertexCount(), 1);
+    checkTree(g);
+}
+
+TEST(BlockCutTreeTest, random) {
+    for (uint64_t k = 1; k <= 3; k++) {
+        checkTree(GraphCreator::kRegular(500, k));
+    }
+    checkTree(GraphCreator::sparseUndirected(500));
+}
+
+TEST(BlockCutTreeTest, cutVertices) {
+    UndirectedGraph g = GraphCreator::sparseUndirected(3000);
+    BlockCutTree t(g);
+    CutVertexIterator c(g);
+    c.init();
+    uint64_t count = 0;
+    while (c.more()) {
+        EXPECT_TRUE(t.isCutVertex(c.next()));
+        count++;
+    }
+    EXPECT_EQ(count, t.getCutVertexCount());
+}
@@ -0,0 +1,105 @@
+#include "sealib/iterator/bridgeiterator.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../src/marker/simplebridgeiterator.h"
+#include "sealib/graph/graphcreator.h"
+#include "testgraphs.h"
+
+using namespace Sealib;  // NOLINT
+using TestGraphs::addEdge;
+
+/**
+ * @return the bridges of g as pairs {min,max}
+ */
+static std::set<std::pair<uint64_t, uint64_t>> lowLinkBridges(
+    UndirectedGraph const &g) {
+    std::set<std::pair<uint64_t, uint64_t>> r;
+    SimpleBridgeIterator b(g);
+    b.init();
+    while (b.more()) {
+        std::pair<uint64_t, uint64_t> p = b.next();
+        r.emplace(std::min(p.first, p.second), std::max(p.first, p.second));
+    }
+    return r;
+}
+
+static UndirectedGraph chain(uint64_t cycles, uint64_t length) {
+    // cycles of the given length, joined by single edges
+    UndirectedGraph g(cycles * length);
+    for (uint64_t c = 0; c < cycles; c++) {
+        for (uint64_t i = 0; i < length; i++) {
+            addEdge(&g, c * length + i, c * length + (i + 1) % length);
+        }
+        if (c > 0) addEdge(&g, c * length - 1, c * length);
+    }
+    return g;
+}
+
+static void checkBridges(UndirectedGraph const &g) {
+    std::set<std::pair<uint64_t, uint64_t>> expected = lowLinkBridges(g),
+                                            actual;
+    BridgeIterator b(g);
+    b.init();
+    while (b.more()) {
+        std::pair<uint64_t, uint64_t> p = b.next();
+        bool fresh = actual.emplace(std::min(p.first, p.second),
+                                    std::max(p.first, p.second))
+                         .second;
+        EXPECT_TRUE(fresh);
+    }
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(BridgeIteratorTest, chain) {
+    UndirectedGraph g = chain(20, 5);
+    checkBridges(g);
+    BridgeIterator b(g);
+    b.init();
+    uint64_t count = 0;
+    while (b.more()) {
+        b.next();
+        count++;
+    }
+    EXPECT_EQ(count, 19);
+}
+
+TEST(BridgeIteratorTest, random) {
+    for (uint64_t k = 1; k <= 3; k++) {
+        checkBridges(GraphCreator::kRegular(2000, k));
+    }
+    checkBridges(GraphCreator::windmill(5, 10));
+}
+
+TEST(BridgeIteratorTest, twoEdgeConnectedComponents) {
+    UndirectedGraph g = chain(20, 5);
+    TwoEdgeConnectedComponents c(g);
+    EXPECT_EQ(c.getCount(), 20);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        EXPECT_EQ(c.getComponent(u), c.getComponent(u - u % 5));
+        if (u >= 5) {
+            EXPECT_NE(c.getComponent(u), c.getComponent(u - 5));
+        }
+    }
+
+    // the endpoints of an edge are in the same component iff it is no bridge
+    for (uint64_t k = 1; k <= 3; k++) {
+        UndirectedGraph h = GraphCreator::kRegular(2000, k);
+        std::set<std::pair<uint64_t, uint64_t>> bridges = lowLinkBridges(h);
+        TwoEdgeConnectedComponents d(h);
+        std::vector<bool> used(d.getCount());
+        for (uint64_t u = 0; u < h.getOrder(); u++) {
+            ASSERT_LT(d.getComponent(u), d.getCount());
+            used[d.getComponent(u)] = true;
+            for (uint64_t l = 0; l < h.deg(u); l++) {
+                uint64_t v = h.head(u, l);
+                bool bridge =
+                    bridges.count({std::min(u, v), std::max(u, v)}) > 0;
+                EXPECT_EQ(d.getComponent(u) != d.getComponent(v), bridge);
+            }
+        }
+        EXPECT_EQ(std::count(used.begin(), used.end(), true), d.getCount());
+    }
+}
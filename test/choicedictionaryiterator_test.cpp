@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <array>
 #include <random>
+#include <vector>
 
 using Sealib::ChoiceDictionaryIterator;
 
@@ -51,3 +52,20 @@ TEST(ChoiceDictionaryIteratorTest, iterator_integrity) {
     }
     // ASSERT_EQ(count, setSize - 18);
 }
+
+TEST(ChoiceDictionaryIteratorTest, range) {
+    Sealib::ChoiceDictionary c(10000);
+    for (uint64_t i = 3; i < 10000; i += 7) c.insert(i);
+    ChoiceDictionaryIterator i1(c), i2(c);
+    std::vector<uint64_t> v1, v2;
+    i1.init();
+    while (i1.more()) v1.push_back(i1.next());
+    for (uint64_t i : Sealib::iterate(i2)) v2.push_back(i);
+    EXPECT_EQ(v1, v2);
+    EXPECT_EQ(v2.size(), 1429);
+    // a range works with STL algorithms
+    Sealib::IteratorRange<ChoiceDictionaryIterator> r = Sealib::iterate(i2);
+    EXPECT_EQ(std::count_if(r.begin(), r.end(),
+                            [](uint64_t i) { return i % 2 == 0; }),
+              714);
+}
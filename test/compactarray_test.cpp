@@ -40,3 +40,18 @@ TEST(CompactArrayTest, alternate) {
         }
     }
 }
+
+// Replace one value by another and check that no other value is touched
+TEST(CompactArrayTest, replaceAll) {
+    for (uint64_t v : {3, 5, 16, 256}) {
+        uint64_t n = 1001;
+        CompactArray a(n, v);
+        for (uint64_t c = 0; c < n; c++) a.insert(c, c % v);
+        a.replaceAll(1, v - 1);
+        for (uint64_t c = 0; c < n; c++) {
+            EXPECT_EQ(a.get(c), c % v == 1 ? v - 1 : c % v);
+        }
+        a.replaceAll(0, 1);
+        for (uint64_t c = 0; c < n; c += v) EXPECT_EQ(a.get(c), 1);
+    }
+}
@@ -0,0 +1,92 @@
+#include "sealib/iterator/connectedcomponents.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "sealib/graph/graphcreator.h"
+#include "testgraphs.h"
+
+using namespace Sealib;  // NOLINT
+using TestGraphs::addEdge;
+
+// A number of paths of different lengths and some isolated vertices, in
+// shuffled vertex order
+static UndirectedGraph paths(uint64_t n, std::vector<uint64_t> *component) {
+    std::vector<uint64_t> order(n);
+    for (uint64_t a = 0; a < n; a++) order[a] = a;
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(n));
+    UndirectedGraph g(n);
+    component->assign(n, 0);
+    uint64_t a = 0, len = 1, c = 0;
+    while (a < n) {
+        for (uint64_t b = a; b < std::min(n, a + len); b++) {
+            (*component)[order[b]] = c;
+            if (b > a) addEdge(&g, order[b - 1], order[b]);
+        }
+        a += len;
+        len = len * 3 % 17 + 1;
+        c++;
+    }
+    return g;
+}
+
+// Two vertices are in the same component iff they have the same label
+static void checkLabels(ConnectedComponents const &c,
+                        std::vector<uint64_t> const &component) {
+    uint64_t n = component.size();
+    std::vector<uint64_t> map(n, INVALID);
+    for (uint64_t u = 0; u < n; u++) {
+        uint64_t l = c.getComponent(u);
+        ASSERT_LT(l, c.getCount());
+        if (map[component[u]] == INVALID) map[component[u]] = l;
+        EXPECT_EQ(map[component[u]], l);
+    }
+}
+
+TEST(ConnectedComponentsTest, paths) {
+    uint64_t n = 5000;
+    std::vector<uint64_t> component;
+    UndirectedGraph g = paths(n, &component);
+    uint64_t count = component[0];
+    for (uint64_t c : component) count = std::max(count, c);
+    count++;
+
+    ConnectedComponents c1 = ConnectedComponents::sequential(g);
+    EXPECT_EQ(c1.getCount(), count);
+    checkLabels(c1, component);
+    for (uint64_t t : {1, 2, 4, 7}) {
+        ConnectedComponents c2 = ConnectedComponents::parallel(g, t);
+        EXPECT_EQ(c2.getCount(), count);
+        checkLabels(c2, component);
+        for (uint64_t u = 0; u < n; u++) {
+            EXPECT_EQ(c2.getComponent(u), c1.getComponent(u));
+        }
+    }
+}
+
+TEST(ConnectedComponentsTest, randomGraphs) {
+    for (uint64_t a = 0; a < 5; a++) {
+        UndirectedGraph g = GraphCreator::sparseUndirected(20000);
+        ConnectedComponents c1 = ConnectedComponents::sequential(g),
+                            c2 = ConnectedComponents::parallel(g);
+        EXPECT_EQ(c1.getCount(), c2.getCount());
+        for (uint64_t u = 0; u < g.getOrder(); u++) {
+            EXPECT_EQ(c1.getComponent(u), c2.getComponent(u));
+        }
+    }
+}
+
+TEST(ConnectedComponentsTest, edgeCases) {
+    UndirectedGraph e(0);
+    EXPECT_EQ(ConnectedComponents::sequential(e).getCount(), 0);
+    EXPECT_EQ(ConnectedComponents::parallel(e).getCount(), 0);
+
+    UndirectedGraph s(10);
+    ConnectedComponents c = ConnectedComponents::parallel(s, 3);
+    EXPECT_EQ(c.getCount(), 10);
+    for (uint64_t u = 0; u < 10; u++) EXPECT_EQ(c.getComponent(u), u);
+
+    UndirectedGraph k = GraphCreator::cycle(1000, 30);
+    EXPECT_EQ(ConnectedComponents::parallel(k).getCount(), 1);
+    EXPECT_EQ(ConnectedComponents::sequential(k).getCount(), 1);
+}
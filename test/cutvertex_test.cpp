@@ -77,4 +77,24 @@ TEST(SimpleCutVertexIteratorTest, cycle) {
     }
 }
 
+TEST(CutVertexIteratorTest, edgeMarkerCursor) {
+    UndirectedGraph g = GraphCreator::kRegular(2000, 3);
+    EdgeMarker e(g);
+    e.init();
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        EdgeMarker::Cursor c = e.cursor(u);
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            EXPECT_EQ(c.isInitialized(k), e.isInitialized(u, k));
+            EXPECT_EQ(c.isTreeEdge(k), e.isTreeEdge(u, k));
+            EXPECT_EQ(c.isBackEdge(k), e.isBackEdge(u, k));
+            EXPECT_EQ(c.isParent(k), e.isParent(u, k));
+            EXPECT_EQ(c.isFullMarked(k), e.isFullMarked(u, k));
+            // every edge is either a tree edge or a back edge (or a loop)
+            if (g.head(u, k) != u) {
+                EXPECT_NE(c.isTreeEdge(k), c.isBackEdge(k));
+            }
+        }
+    }
+}
+
 }  // namespace Sealib
@@ -1,10 +1,16 @@
 #include "sealib/iterator/dfs.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
 #include <random>
 #include <stack>
 #include <vector>
+#include "sealib/collection/compactarray.h"
+#include "sealib/collection/segmentstack.h"
+#include "sealib/collection/staticspacestorage.h"
 #include "sealib/graph/graphcreator.h"
+#include "sealib/graph/graphrepresentations.h"
 #include "sealib/graph/undirectedgraph.h"
 #include "sealib/iterator/iterator.h"
 
@@ -324,6 +330,234 @@ TEST(DFSTest, nloglognImbalanced) {
     EXPECT_EQ(c4, 200);
 }
 
+// Check that the budget selects the expected variant and that each variant
+// still calls the user-defined procedures exactly n resp. m times
+TEST_P(DFSTest, budgetUserproc) {
+    DirectedGraph const& g = GetParam();
+    uint64_t budgets[] = {
+        DFS::estimateByteSize(g, DFSVariant::standard),
+        DFS::estimateByteSize(g, DFSVariant::nloglognBit),
+        DFS::estimateByteSize(g, DFSVariant::nBit), 0};
+    DFSVariant expected[] = {DFSVariant::standard, DFSVariant::nloglognBit,
+                             DFSVariant::nBit, DFSVariant::nBit};
+    for (uint64_t a = 0; a < 4; a++) {
+        c1 = c2 = c3 = c4 = 0;
+        EXPECT_EQ(DFS::run(g, budgets[a], incr1, incr2, incr3, incr4),
+                  expected[a]);
+        EXPECT_EQ(c1, ORDER);
+        EXPECT_EQ(c2, DEGREE * ORDER);
+        EXPECT_EQ(c3, DEGREE * ORDER);
+        EXPECT_EQ(c4, ORDER);
+    }
+}
+
+TEST_P(DFSTest2, budgetUserproc) {
+    UndirectedGraph const& g = GetParam();
+    uint64_t budget = DFS::estimateByteSize(g, DFSVariant::nplusmBit);
+    if (budget < DFS::estimateByteSize(g, DFSVariant::standard)) {
+        EXPECT_EQ(DFS::run(g, budget, incr1, incr2, incr3, incr4),
+                  DFSVariant::nplusmBit);
+        EXPECT_EQ(c1, 5 * ORDER);
+        EXPECT_EQ(c2, 5 * ORDER * DEGREE);
+        EXPECT_EQ(c3, 5 * ORDER * DEGREE);
+        EXPECT_EQ(c4, 5 * ORDER);
+    }
+}
+
+TEST(DFSTest, nBitSegmentSize) {
+    EXPECT_EQ(DFS::nBitSegmentSize(ORDER, 0), 3);
+    EXPECT_EQ(DFS::nBitSegmentSize(ORDER, UINT64_MAX / 2), ORDER + 1);
+    uint64_t q = DFS::nBitSegmentSize(ORDER, 8000);
+    EXPECT_GT(q, 3);
+    EXPECT_LE(DFS::estimateByteSize(DirectedGraph(ORDER), DFSVariant::nBit, q),
+              8000);
+}
+
+// Check the estimates against the structures each variant allocates
+TEST(DFSTest, estimateByteSize) {
+    UndirectedGraph g = GraphCreator::kRegular(500, 6);
+    uint64_t n = g.getOrder();
+    CompactArray color(n, 3);
+    StaticSpaceStorage parent(g);
+    EXPECT_EQ(DFS::estimateByteSize(g, DFSVariant::nplusmBit),
+              color.byteSize() + parent.byteSize());
+    ExtendedSegmentStack es(n, g, &color);
+    EXPECT_EQ(DFS::estimateByteSize(g, DFSVariant::nloglognBit),
+              color.byteSize() + es.byteSize());
+    for (uint64_t q : {3, 40}) {
+        for (uint64_t c : {0, 5}) {
+            BasicSegmentStack s(q, c);
+            EXPECT_EQ(DFS::estimateByteSize(g, DFSVariant::nBit, q, c),
+                      color.byteSize() + s.byteSize());
+        }
+    }
+}
+
+TEST(DFSTest, estimateByteSizeTinyGraphs) {
+    uint64_t big =
+        DFS::estimateByteSize(DirectedGraph(1024), DFSVariant::nloglognBit);
+    for (uint64_t n : {0, 1}) {
+        uint64_t r =
+            DFS::estimateByteSize(DirectedGraph(n), DFSVariant::nloglognBit);
+        EXPECT_GT(r, 0);
+        EXPECT_LT(r, big);
+    }
+}
+
+// Check that the iterators and the procedures report the same restorations
+TEST_P(DFSTest, restorationStats) {
+    DirectedGraph const& g = GetParam();
+    DFSStats s1, s2;
+    DFS::nBitDFS(g, DFS_NOP_PROCESS, DFS_NOP_EXPLORE, DFS_NOP_EXPLORE,
+                 DFS_NOP_PROCESS, &s1);
+    EXPECT_GT(s1.restorations, 0);
+    EXPECT_GE(s1.rescannedVertices, s1.restorations);
+    EXPECT_GT(s1.rescannedEdges, 0);
+    EXPECT_GT(s1.visitSeconds, 0);
+    Iterator<UserCall>* iter = DFS::getnBitDFSIterator(g, 0, &s2);
+    while (iter->more()) iter->next();
+    free(iter);
+    EXPECT_EQ(s2.restorations, s1.restorations);
+    EXPECT_EQ(s2.rescannedVertices, s1.rescannedVertices);
+    EXPECT_EQ(s2.rescannedEdges, s1.rescannedEdges);
+
+    DFSStats s3, s4;
+    DFS::nloglognBitDFS(g, DFS_NOP_PROCESS, DFS_NOP_EXPLORE, DFS_NOP_EXPLORE,
+                        DFS_NOP_PROCESS, &s3);
+    iter = DFS::getnloglognDFSIterator(g, 0, &s4);
+    while (iter->more()) iter->next();
+    free(iter);
+    EXPECT_EQ(s4.restorations, s3.restorations);
+    EXPECT_EQ(s4.rescannedVertices, s3.rescannedVertices);
+}
+
+// Check that a budget for the nBitDFS stack is partly used for checkpoints
+TEST_P(DFSTest, checkpointRestorations) {
+    DirectedGraph const& g = GetParam();
+    uint64_t budget = DFS::estimateByteSize(g, DFSVariant::nBit, 40);
+    DFSStats s;
+    EXPECT_EQ(DFS::run(g, budget, incr1, incr2, incr3, incr4, &s),
+              DFSVariant::nBit);
+    EXPECT_EQ(c1, ORDER);
+    EXPECT_EQ(c2, DEGREE * ORDER);
+    EXPECT_EQ(c3, DEGREE * ORDER);
+    EXPECT_EQ(c4, ORDER);
+    EXPECT_GT(s.checkpointRestorations, 0);
+    EXPECT_LE(s.checkpointRestorations, s.restorations);
+    EXPECT_LE(DFS::estimateByteSize(g, DFSVariant::nBit, 10,
+                                    DFS::nBitCheckpoints(ORDER, budget, 10)),
+              budget);
+}
+
+TEST(DFSTest, bigVertexStats) {
+    DirectedGraph g = Sealib::GraphCreator::imbalanced(200);
+    DFSStats s;
+    DFS::nloglognBitDFS(g, DFS_NOP_PROCESS, DFS_NOP_EXPLORE, DFS_NOP_EXPLORE,
+                        DFS_NOP_PROCESS, &s);
+    EXPECT_GT(s.maxBigVertices, 0);
+}
+
+/**
+ * @return all user calls of the given iterator, retrieved with next() or in
+ * batches of the given size (if batch > 0)
+ */
+static std::vector<UserCall> allCalls(Iterator<UserCall>* d, uint64_t batch) {
+    std::vector<UserCall> r;
+    d->init();
+    if (batch == 0) {
+        while (d->more()) r.push_back(d->next());
+    } else {
+        std::vector<UserCall> buf(batch);
+        uint64_t c;
+        while ((c = d->nextBatch(buf.data(), batch)) > 0) {
+            r.insert(r.end(), buf.begin(), buf.begin() + c);
+        }
+    }
+    free(d);
+    return r;
+}
+
+TEST(DFSTest, nextBatch) {
+    DirectedGraph g = GraphCreator::kOutdegree(500, 4);
+    UndirectedGraph ug = GraphCreator::kRegular(500, 4);
+    for (uint64_t batch : {1, 7, 1000}) {
+        EXPECT_EQ(allCalls(DFS::getStandardDFSIterator(g, 0), batch),
+                  allCalls(DFS::getStandardDFSIterator(g, 0), 0));
+        EXPECT_EQ(allCalls(DFS::getnBitDFSIterator(g, 0), batch),
+                  allCalls(DFS::getnBitDFSIterator(g, 0), 0));
+        EXPECT_EQ(allCalls(DFS::getnloglognDFSIterator(g, 0), batch),
+                  allCalls(DFS::getnloglognDFSIterator(g, 0), 0));
+        EXPECT_EQ(allCalls(DFS::getnplusmBitDFSIterator(ug, 0), batch),
+                  allCalls(DFS::getnplusmBitDFSIterator(ug, 0), 0));
+    }
+    std::vector<UserCall> c = allCalls(DFS::getStandardDFSIterator(g, 0), 0);
+    EXPECT_EQ(c.size(), 2 * 500 + 2 * 500 * 4 + 1);
+}
+
+TEST(DFSTest, range) {
+    DirectedGraph g = GraphCreator::kOutdegree(500, 4);
+    Iterator<UserCall>* d = DFS::getnloglognDFSIterator(g, 0);
+    std::vector<UserCall> c;
+    for (UserCall x : iterate(d)) c.push_back(x);
+    free(d);
+    EXPECT_EQ(c, allCalls(DFS::getnloglognDFSIterator(g, 0), 0));
+}
+
+// Interrupt an iterator at several points, continue a new iterator from a
+// checkpoint and check that the remaining user calls are the same
+static void checkResume(DirectedGraph const& g,
+                        ResumableDFSIterator* (*create)(Graph const&, uint64_t,
+                                                        DFSStats*)) {
+    std::vector<UserCall> all;
+    ResumableDFSIterator* ref = create(g, 0, nullptr);
+    while (ref->more()) all.push_back(ref->next());
+    free(ref);
+    for (uint64_t stop : {static_cast<uint64_t>(0), all.size() / 3,
+                          all.size() / 2 + 1, all.size() - 1}) {
+        ResumableDFSIterator* d = create(g, 0, nullptr);
+        for (uint64_t a = 0; a < stop; a++) d->next();
+        d->checkpoint("dfs_checkpoint.tmp");
+        free(d);
+        ResumableDFSIterator* e = create(g, 0, nullptr);
+        e->resume("dfs_checkpoint.tmp");
+        uint64_t a = stop;
+        while (e->more()) {
+            UserCall c = e->next();
+            ASSERT_LT(a, all.size());
+            EXPECT_EQ(c, all[a]);
+            a++;
+        }
+        EXPECT_EQ(a, all.size());
+        free(e);
+    }
+    std::remove("dfs_checkpoint.tmp");
+}
+
+TEST_P(DFSTest, resumenBit) {
+    checkResume(GetParam(), DFS::getnBitDFSIterator);
+}
+
+TEST_P(DFSTest, resumenloglogn) {
+    checkResume(GetParam(), DFS::getnloglognDFSIterator);
+}
+
+TEST(DFSTest, resumeMismatch) {
+    DirectedGraph g1 = GraphCreator::kOutdegree(100, 5),
+                  g2 = GraphCreator::kOutdegree(101, 5);
+    ResumableDFSIterator* d = DFS::getnBitDFSIterator(g1, 0);
+    d->next();
+    d->checkpoint("dfs_checkpoint.tmp");
+    ResumableDFSIterator* e = DFS::getnloglognDFSIterator(g1, 0);
+    EXPECT_THROW(e->resume("dfs_checkpoint.tmp"), CheckpointMismatch);
+    ResumableDFSIterator* f = DFS::getnBitDFSIterator(g2, 0);
+    EXPECT_THROW(f->resume("dfs_checkpoint.tmp"), CheckpointMismatch);
+    std::remove("dfs_checkpoint.tmp");
+    EXPECT_THROW(f->resume("dfs_checkpoint.tmp"), CheckpointIOError);
+    free(d);
+    free(e);
+    free(f);
+}
+
 auto* graph = new uint64_t[19]{5,  9,  7, 9,  9, 7,  12, 1, 17, 2,
                                12, 14, 3, 14, 4, 12, 17, 5, 14};
 uint64_t controllSum = (2 * (1 + 2 + 3 + 4 + 5));
@@ -340,8 +574,82 @@ void postTwo(uint64_t a) {
 }
 
 TEST(DFSTest, inplace_dfs_all_of_grade_ge_2) {
+    std::vector<uint64_t> before(graph, graph + 19);
     DFS::runLinearTimeInplaceDFS(graph, preTwo, postTwo, 1);
     EXPECT_EQ(0, controllSum);
+    EXPECT_EQ(std::vector<uint64_t>(graph, graph + 19), before);
+}
+
+/**
+ * @return the sorted entries of each adjacency array of a graph in swapped
+ * begin pointer representation (the first entry is stored at A[v])
+ */
+static std::vector<std::vector<uint64_t>> sortedArrays(uint64_t const *a) {
+    uint64_t n = a[0], size = n + a[n + 1] + 2, v = 0;
+    std::vector<std::vector<uint64_t>> r(n + 1);
+    for (uint64_t p = n + 2; p < size; p++) {
+        if (a[p] <= n) {
+            v = a[p];
+            r[v].push_back(a[v]);
+        } else {
+            r[v].push_back(a[p]);
+        }
+    }
+    for (std::vector<uint64_t> &x : r) std::sort(x.begin(), x.end());
+    return r;
+}
+
+static void checkInplace(UndirectedGraph const &g, uint64_t startVertex) {
+    uint64_t *a = Graphrepresentations::graphToStandard(g);
+    Graphrepresentations::standardToSwappedBeginpointer(a);
+    uint64_t n = g.getOrder();
+    std::vector<std::vector<uint64_t>> before = sortedArrays(a);
+    std::vector<uint64_t> pre(n + 1), post(n + 1);
+    std::stack<uint64_t> s;
+    DFS::runLinearTimeInplaceDFS(a,
+                                 [&](uint64_t u) {
+                                     pre[u]++;
+                                     s.push(u);
+                                 },
+                                 [&](uint64_t u) {
+                                     post[u]++;
+                                     EXPECT_EQ(s.top(), u);
+                                     s.pop();
+                                 },
+                                 startVertex);
+    for (uint64_t u = 1; u <= n; u++) {
+        EXPECT_EQ(pre[u], 1);
+        EXPECT_EQ(post[u], 1);
+    }
+    // the entries of an adjacency array may be permuted
+    EXPECT_EQ(sortedArrays(a), before);
+    delete[] a;
+}
+
+TEST(DFSTest, inplace_dfs_converted) {
+    checkInplace(GraphCreator::cycle(1000, 200), 1);
+    checkInplace(GraphCreator::cycle(1000, 0), 500);
+    checkInplace(GraphCreator::windmill(10, 50), 2);
+    // deep enough for a recursive traversal to overflow the stack
+    checkInplace(GraphCreator::cycle(200000, 40000), 7);
+}
+
+TEST(DFSTest, inplace_dfs_invalid) {
+    uint64_t *a = Graphrepresentations::graphToStandard(
+        GraphCreator::windmill(4, 3));
+    Graphrepresentations::standardToSwappedBeginpointer(a);
+    std::vector<uint64_t> before(a, a + a[0] + a[a[0] + 1] + 2);
+    EXPECT_THROW(DFS::runLinearTimeInplaceDFS(a, DFS_NOP_PROCESS,
+                                              DFS_NOP_PROCESS, 0),
+                 std::invalid_argument);
+    EXPECT_THROW(DFS::runLinearTimeInplaceDFS(a, DFS_NOP_PROCESS,
+                                              DFS_NOP_PROCESS, 11),
+                 std::invalid_argument);
+    a[a[0] + 3] = a[0] + 1;
+    EXPECT_THROW(DFS::runLinearTimeInplaceDFS(a, DFS_NOP_PROCESS,
+                                              DFS_NOP_PROCESS, 1),
+                 std::invalid_argument);
+    delete[] a;
 }
 
 }  // namespace Sealib
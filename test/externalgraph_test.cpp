@@ -0,0 +1,75 @@
+#include "sealib/graph/externalgraph.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "sealib/graph/graphcreator.h"
+#include "sealib/iterator/bfs.h"
+#include "sealib/iterator/dfs.h"
+
+using namespace Sealib;  // NOLINT
+
+static const char *FILE_NAME = "externalgraph.tmp";
+
+TEST(ExternalGraphTest, adjacency) {
+    DirectedGraph g = GraphCreator::kOutdegree(3000, 7);
+    ExternalGraph::write(g, FILE_NAME);
+    // a tiny cache: 4 blocks of 8 words
+    ExternalGraph e(FILE_NAME, 256, 64, 2);
+    ASSERT_EQ(e.getOrder(), g.getOrder());
+    EXPECT_EQ(e.getSize(), 3000 * 7);
+    EXPECT_EQ(e.byteSize(), 256);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        ASSERT_EQ(e.deg(u), g.deg(u));
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            EXPECT_EQ(e.head(u, k), g.head(u, k));
+        }
+    }
+    // random accesses
+    for (uint64_t u = 2999; u >= 7; u -= 7) {
+        EXPECT_EQ(e.head(u, 3), g.head(u, 3));
+    }
+    ExternalGraphStats s = e.getStats();
+    EXPECT_GT(s.requests, 0);
+    EXPECT_GE(s.bytesRead, (2 + 3001 + 21000) * sizeof(uint64_t));
+    EXPECT_GT(s.hits, s.misses);
+    e.resetStats();
+    EXPECT_EQ(e.getStats().bytesRead, 0);
+    std::remove(FILE_NAME);
+}
+
+TEST(ExternalGraphTest, traversals) {
+    DirectedGraph g = GraphCreator::kOutdegree(3000, 10);
+    ExternalGraph::write(g, FILE_NAME);
+    ExternalGraph e(FILE_NAME, 1 << 14, 1 << 9);
+
+    std::vector<uint64_t> c1, c2;
+    DFS::nloglognBitDFS(g, [&c1](uint64_t u) { c1.push_back(u); },
+                        DFS_NOP_EXPLORE, DFS_NOP_EXPLORE, DFS_NOP_PROCESS);
+    DFS::nloglognBitDFS(e, [&c2](uint64_t u) { c2.push_back(u); },
+                        DFS_NOP_EXPLORE, DFS_NOP_EXPLORE, DFS_NOP_PROCESS);
+    EXPECT_EQ(c1, c2);
+
+    c1.clear();
+    c2.clear();
+    DFS::nBitDFS(e, [&c2](uint64_t u) { c2.push_back(u); });
+    DFS::nBitDFS(g, [&c1](uint64_t u) { c1.push_back(u); });
+    EXPECT_EQ(c1, c2);
+
+    c1.clear();
+    c2.clear();
+    BFS(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE)
+        .forEach([&c1](std::pair<uint64_t, uint64_t> p) {
+            c1.push_back(p.first);
+        });
+    BFS(e, BFS_NOP_PROCESS, BFS_NOP_EXPLORE)
+        .forEach([&c2](std::pair<uint64_t, uint64_t> p) {
+            c2.push_back(p.first);
+        });
+    EXPECT_EQ(c1, c2);
+    std::remove(FILE_NAME);
+}
+
+TEST(ExternalGraphTest, missingFile) {
+    std::remove(FILE_NAME);
+    EXPECT_THROW(ExternalGraph e(FILE_NAME), ExternalGraphError);
+}
@@ -156,3 +156,30 @@ TEST(VirtualGraphTest, virtualEdges) {
         g.addEdge(u, u + 1);
     }
 }
+
+TEST(VirtualGraphTest, originalIndices) {
+    UndirectedGraph baseGraph = GraphCreator::windmill(5, 8);
+    VirtualGraph g(baseGraph);
+    uint64_t d0 = baseGraph.deg(0), d12 = baseGraph.deg(12);
+    g.addEdge(0, 12);
+    g.addEdge(20, 0);
+    EXPECT_EQ(g.indexOf(0, 12), d0);
+    EXPECT_EQ(g.indexOf(0, 20), d0 + 1);
+    EXPECT_EQ(g.originalHead(0, d0 + 1), 20);
+    EXPECT_EQ(g.originalMate(0, d0), d12);
+    EXPECT_EQ(g.originalMate(12, d12), d0);
+    for (uint64_t k = 0; k < baseGraph.deg(12); k++) {
+        EXPECT_EQ(g.indexOf(12, baseGraph.head(12, k)), k);
+        EXPECT_EQ(g.originalMate(12, k), baseGraph.mate(12, k));
+    }
+
+    // removing 12 takes its virtual edge along, the other one keeps its index
+    g.removeVertex(12);
+    ASSERT_EQ(g.deg(0), d0 + 1);
+    EXPECT_EQ(g.head(0, d0), 20);
+    EXPECT_EQ(g.indexOf(0, 12), INVALID);
+    EXPECT_EQ(g.indexOf(0, 20), d0 + 1);
+    g.addEdge(0, 30);
+    EXPECT_EQ(g.indexOf(0, 30), d0);
+    EXPECT_EQ(g.deg(0), d0 + 2);
+}
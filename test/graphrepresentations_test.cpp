@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <stdlib.h>
 #include <sealib/graph/compactgraph.h>
+#include <sealib/graph/graphcreator.h>
 #include <sealib/graph/graphrepresentations.h>
 
 using Sealib::Graphrepresentations;
@@ -57,3 +58,40 @@ TEST(GraphrepresentationsTest, crosspointer) {
     Graphrepresentations::standardToCrosspointer(A);
     SUCCEED();
 }
+
+TEST(GraphrepresentationsTest, graphToStandard) {
+    Sealib::UndirectedGraph g = Sealib::GraphCreator::windmill(5, 4);
+    Sealib::CompactGraph c(Graphrepresentations::graphToStandard(g));
+
+    ASSERT_EQ(c.getOrder(), g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        ASSERT_EQ(c.deg(u), g.deg(u));
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            EXPECT_EQ(c.head(u, k), g.head(u, k) + 1);
+        }
+    }
+}
+
+TEST(GraphrepresentationsTest, standardToUndirected) {
+    Sealib::UndirectedGraph g = Sealib::GraphCreator::kRegular(200, 5);
+    uint64_t *A = Graphrepresentations::graphToStandard(g);
+    Sealib::UndirectedGraph h = Graphrepresentations::standardToUndirected(A);
+
+    ASSERT_EQ(h.getOrder(), g.getOrder());
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        ASSERT_EQ(h.deg(u), g.deg(u));
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            uint64_t v = h.head(u, k);
+            EXPECT_EQ(v, g.head(u, k));
+            EXPECT_EQ(h.head(v, h.mate(u, k)), u);
+            EXPECT_EQ(h.mate(v, h.mate(u, k)), k);
+        }
+    }
+
+    // an arc without its reverse arc
+    uint64_t *B = new uint64_t[7]{3, 5, 2, 6, 2, 2, 1};
+    EXPECT_THROW(Graphrepresentations::standardToUndirected(B),
+                 std::invalid_argument);
+    delete[] A;
+    delete[] B;
+}
@@ -4,6 +4,10 @@
 #include "../src/trail/simpletrailstructure.h"
 #include <sealib/iterator/eulertrail.h>
 #include <stdlib.h>
+#include <map>
+#include <random>
+#include <utility>
+#include "../src/trail/trailstorage.h"
 #include "../src/trail/trailstructure.h"
 
 TEST(EulerTrailTest, hierholzerTrail) {
@@ -26,3 +30,106 @@ TEST(EulerTrailTest, hierholzerTrail) {
     Sealib::NaiveEulerTrail et3(graph_ptr);
     SUCCEED();
 }
+
+// every edge is traversed exactly once: the consecutive vertices of the
+// trails use up the edges of the graph (parallel edges are counted)
+static void expectPartition(const std::shared_ptr<Sealib::UndirectedGraph> &g) {
+    std::map<std::pair<uint64_t, uint64_t>, int64_t> edges;
+    uint64_t arcs = 0;
+    for (uint64_t u = 0; u < g->getOrder(); u++) {
+        arcs += g->deg(u);
+        for (uint64_t k = 0; k < g->deg(u); k++) {
+            if (u < g->head(u, k)) edges[{u, g->head(u, k)}]++;
+        }
+    }
+    Sealib::EulerTrail<Sealib::TrailStructure> et(g);
+    uint64_t steps = 0, trails = 0, last = Sealib::INVALID;
+    for (auto v : et) {
+        uint64_t u = std::get<0>(v);
+        steps++;
+        if (last != Sealib::INVALID) {
+            edges[{std::min(last, u), std::max(last, u)}]--;
+        }
+        last = u;
+        if (std::get<1>(v)) {
+            trails++;
+            last = Sealib::INVALID;
+        }
+        ASSERT_LE(steps, arcs + g->getOrder());
+    }
+    EXPECT_GT(trails, 0);
+    EXPECT_EQ(steps, arcs / 2 + trails);
+    for (auto const &e : edges) {
+        EXPECT_EQ(e.second, 0) << e.first.first << "-" << e.first.second;
+    }
+}
+
+TEST(EulerTrailTest, partition) {
+    expectPartition(std::make_shared<Sealib::UndirectedGraph>(
+        Sealib::GraphCreator::kRegular(300, 4)));
+    expectPartition(std::make_shared<Sealib::UndirectedGraph>(
+        Sealib::GraphCreator::kRegular(300, 3)));
+    expectPartition(std::make_shared<Sealib::UndirectedGraph>(
+        Sealib::GraphCreator::windmill(5, 20)));
+}
+
+// The per-vertex trail structures that the arena replaced
+struct SeparateTrailStructure : Sealib::TrailStructure {
+    explicit SeparateTrailStructure(uint64_t degree)
+        : Sealib::TrailStructure(degree) {}
+};
+
+// The construction loop of EulerTrail, run on any trail storage
+template <class T>
+static void buildTrails(Sealib::UndirectedGraph const &g,
+                        Sealib::TrailStorage<T> *t) {
+    uint64_t u = t->findStartingNode();
+    while (u != Sealib::INVALID) {
+        uint64_t kOld = Sealib::INVALID;
+        if (t->isEven(u) && t->isGrey(u)) kOld = t->getLastClosed(u);
+        uint64_t kFirst = t->leave(u), k = kFirst, uMate;
+        do {
+            uMate = g.mate(u, k);
+            u = g.head(u, k);
+            k = t->enter(u, uMate);
+        } while (k != Sealib::INVALID);
+        if (kOld != Sealib::INVALID) {
+            uint64_t kOldMatch = t->getMatched(u, kOld);
+            if (kOldMatch != kOld) t->marry(u, kOldMatch, kFirst);
+            t->marry(u, uMate, kOld);
+        }
+        u = t->findStartingNode();
+    }
+    t->finish();
+}
+
+// Random multigraphs with parallel edges and vertices of degree > 64: the
+// arena matches the arcs like the separate structures of each vertex
+TEST(EulerTrailTest, arenaMatchesSeparateStructures) {
+    std::mt19937_64 r(50);
+    for (uint64_t c = 0; c < 60; c++) {
+        uint64_t n = c % 3 == 0 ? 12 : 2 + c % 40,
+                 m = c % 3 == 0 ? 1000 : (c * 7) % (4 * n) + 1;
+        Sealib::UndirectedGraph g(n);
+        for (uint64_t e = 0; e < m; e++) {
+            uint64_t u = r() % n, v = r() % n;
+            if (u == v) continue;
+            uint64_t i1 = g.deg(u), i2 = g.deg(v);
+            g.getNode(u).addAdjacency({v, i2});
+            g.getNode(v).addAdjacency({u, i1});
+        }
+        Sealib::TrailStorage<Sealib::TrailStructure> a(g);
+        Sealib::TrailStorage<SeparateTrailStructure> b(g);
+        buildTrails(g, &a);
+        buildTrails(g, &b);
+        for (uint64_t u = 0; u < n; u++) {
+            ASSERT_EQ(a.hasStartingArc(u), b.hasStartingArc(u));
+            if (a.hasStartingArc(u)) {
+                EXPECT_EQ(a.getStartingArc(u), b.getStartingArc(u));
+            }
+            for (uint64_t k = 0; k < g.deg(u); k++) {
+                EXPECT_EQ(a.getMatched(u, k), b.getMatched(u, k));
+            }
+        }
+    }
+}
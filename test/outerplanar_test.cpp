@@ -148,4 +148,96 @@ TEST(OuterplanarCheckerTest, sample5) {
     EXPECT_TRUE(OuterplanarChecker(g).isOuterplanar()) << "failed at 5/1-cycle";
 }
 
+static UndirectedGraph fromEdges(
+    uint64_t n, std::vector<std::pair<uint64_t, uint64_t>> const &edges) {
+    std::vector<ExtendedNode> nodes(n);
+    for (std::pair<uint64_t, uint64_t> e : edges) {
+        nodes[e.first].addAdjacency({e.second, nodes[e.second].getDegree()});
+        nodes[e.second].addAdjacency(
+            {e.first, nodes[e.first].getDegree() - 1});
+    }
+    return UndirectedGraph(std::move(nodes));
+}
+
+// Check that the given successor array is a Hamiltonian cycle of G and that no
+// two chords of G cross with respect to it
+static void checkOuterFace(UndirectedGraph const &g, CompactArray const &s) {
+    uint64_t n = g.getOrder();
+    std::vector<uint64_t> pos(n, INVALID);
+    uint64_t u = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        ASSERT_EQ(pos[u], INVALID);
+        pos[u] = i;
+        bool isEdge = false;
+        for (uint64_t k = 0; k < g.deg(u); k++) {
+            isEdge |= g.head(u, k) == s.get(u);
+        }
+        ASSERT_TRUE(isEdge) << u;
+        u = s.get(u);
+    }
+    ASSERT_EQ(u, 0);
+    std::vector<std::pair<uint64_t, uint64_t>> chords;
+    for (uint64_t a = 0; a < n; a++) {
+        for (uint64_t k = 0; k < g.deg(a); k++) {
+            uint64_t b = g.head(a, k);
+            if (pos[a] < pos[b]) {
+                chords.push_back({pos[a], pos[b]});
+            }
+        }
+    }
+    for (std::pair<uint64_t, uint64_t> c1 : chords) {
+        for (std::pair<uint64_t, uint64_t> c2 : chords) {
+            EXPECT_FALSE(c1.first < c2.first && c2.first < c1.second &&
+                         c1.second < c2.second);
+        }
+    }
+}
+
+TEST(OuterplanarCheckerTest, outerFace) {
+    for (UndirectedGraph const &g :
+         {GraphCreator::triangulated(300), GraphCreator::cycle(300, 40),
+          fromEdges(5, {{0, 1}, {1, 3}, {2, 4}, {4, 1}, {4, 0}, {3, 2}}),
+          fromEdges(9, {{8, 7}, {2, 1}, {0, 3}, {7, 2}, {6, 4}, {7, 6}, {3, 8},
+                        {5, 3}, {5, 0}, {8, 5}, {4, 2}, {1, 5}, {2, 5}})}) {
+        CompactArray s(1);
+        OuterplanarWitness w;
+        ASSERT_TRUE(OuterplanarChecker(g).isOuterplanar(&s, &w));
+        EXPECT_EQ(w.type, OuterplanarWitness::NONE);
+        checkOuterFace(g, s);
+    }
+}
+
+TEST(OuterplanarCheckerTest, witness) {
+    OuterplanarWitness w;
+    // K2,3 with poles 0 and 1, plus the edge {0,1}
+    UndirectedGraph k113 = fromEdges(
+        5, {{0, 1}, {0, 2}, {2, 1}, {0, 3}, {3, 1}, {0, 4}, {4, 1}});
+    EXPECT_FALSE(SimpleOuterplanarChecker(k113).isOuterplanar());
+    EXPECT_FALSE(OuterplanarChecker(k113).isOuterplanar(nullptr, &w));
+    EXPECT_EQ(w.type, OuterplanarWitness::SHARED_EDGE);
+    EXPECT_EQ(std::min(w.u, w.v), 0);
+    EXPECT_EQ(std::max(w.u, w.v), 1);
+
+    // K2,3 alone: no chain is closed, the first one is replaced by a virtual
+    // edge {0,1}, which then borders three faces
+    UndirectedGraph k23 =
+        fromEdges(5, {{0, 2}, {2, 1}, {0, 3}, {3, 1}, {0, 4}, {4, 1}});
+    EXPECT_FALSE(OuterplanarChecker(k23).isOuterplanar(nullptr, &w));
+    EXPECT_EQ(w.type, OuterplanarWitness::SHARED_EDGE);
+    EXPECT_EQ(std::min(w.u, w.v), 0);
+    EXPECT_EQ(std::max(w.u, w.v), 1);
+
+    // K4 plus a vertex on one of its edges
+    UndirectedGraph k4 = fromEdges(
+        5, {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 4}, {4, 3}, {2, 3}});
+    EXPECT_FALSE(OuterplanarChecker(k4).isOuterplanar(nullptr, &w));
+    EXPECT_EQ(w.type, OuterplanarWitness::NO_CHAIN);
+
+    UndirectedGraph g = GraphCreator::triangulated(100);
+    g.getNode(1).addAdjacency({g.getOrder() - 2, 3});
+    g.getNode(g.getOrder() - 2).addAdjacency({1, 3});
+    EXPECT_FALSE(OuterplanarChecker(g).isOuterplanar(nullptr, &w));
+    EXPECT_EQ(w.type, OuterplanarWitness::TOO_MANY_EDGES);
+}
+
 }  // namespace Sealib
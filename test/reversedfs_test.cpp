@@ -54,3 +54,30 @@ TEST_P(ReverseDFSTest, comparison) {
     // printf(" ]\n");
     EXPECT_TRUE(equal);
 }
+
+TEST_P(ReverseDFSTest, nextBatch) {
+    DirectedGraph const& g = GetParam();
+    ReverseDFS r1(g), r2(g);
+    r1.init();
+    r2.init();
+    std::vector<UserCall> v1, v2;
+    while (r1.more()) v1.push_back(r1.next());
+    UserCall buf[100];
+    uint64_t c;
+    while ((c = r2.nextBatch(buf, 100)) > 0) {
+        v2.insert(v2.end(), buf, buf + c);
+    }
+    EXPECT_EQ(v1, v2);
+}
+
+TEST_P(ReverseDFSTest, parallel) {
+    DirectedGraph const& g = GetParam();
+    ReverseDFS r1(g), r2(g, 4);
+    r1.init();
+    r2.init();
+    std::vector<UserCall> v1, v2;
+    while (r1.more()) v1.push_back(r1.next());
+    while (r2.more()) v2.push_back(r2.next());
+    EXPECT_EQ(v1, v2);
+    EXPECT_GT(r2.byteSize(), r1.byteSize());
+}
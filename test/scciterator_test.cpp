@@ -13,3 +13,81 @@ TEST(SCCIteratorTest, noDuplicates) {
     s.next();
     SUCCEED();
 }
+
+/**
+ * @return the SCC number of every vertex (Kosaraju, with explicit
+ * adjacency lists)
+ */
+static std::vector<uint64_t> referenceSCC(DirectedGraph const &g) {
+    uint64_t n = g.getOrder();
+    DirectedGraph t = GraphCreator::transpose(g);
+    std::vector<bool> seen(n);
+    std::vector<uint64_t> order;
+    for (uint64_t r = 0; r < n; r++) {
+        if (seen[r]) continue;
+        std::vector<std::pair<uint64_t, uint64_t>> st{{r, 0}};
+        seen[r] = true;
+        while (!st.empty()) {
+            uint64_t u = st.back().first, k = st.back().second++;
+            if (k < g.deg(u)) {
+                uint64_t v = g.head(u, k);
+                if (!seen[v]) {
+                    seen[v] = true;
+                    st.emplace_back(v, 0);
+                }
+            } else {
+                order.push_back(u);
+                st.pop_back();
+            }
+        }
+    }
+    std::vector<uint64_t> comp(n, INVALID);
+    uint64_t count = 0;
+    for (uint64_t i = n; i > 0; i--) {
+        uint64_t r = order[i - 1];
+        if (comp[r] != INVALID) continue;
+        std::vector<uint64_t> st{r};
+        comp[r] = count;
+        while (!st.empty()) {
+            uint64_t u = st.back();
+            st.pop_back();
+            for (uint64_t k = 0; k < t.deg(u); k++) {
+                uint64_t v = t.head(u, k);
+                if (comp[v] == INVALID) {
+                    comp[v] = count;
+                    st.push_back(v);
+                }
+            }
+        }
+        count++;
+    }
+    return comp;
+}
+
+TEST(SCCIteratorTest, components) {
+    DirectedGraph g = GraphCreator::kOutdegree(3000, 1);
+    std::vector<uint64_t> expected = referenceSCC(g);
+    std::vector<uint64_t> comp(g.getOrder(), INVALID);
+    uint64_t count = 0;
+    SCCIterator s(g, [&](uint64_t u) {
+        EXPECT_EQ(comp[u], INVALID);
+        comp[u] = count;
+    });
+    s.init();
+    while (s.more()) {
+        s.next();
+        count++;
+    }
+    // the same partition, up to the numbering of the components
+    std::vector<uint64_t> map(count, INVALID);
+    for (uint64_t u = 0; u < g.getOrder(); u++) {
+        ASSERT_NE(comp[u], INVALID);
+        if (map[comp[u]] == INVALID) map[comp[u]] = expected[u];
+        EXPECT_EQ(map[comp[u]], expected[u]);
+    }
+    std::vector<bool> used(g.getOrder());
+    for (uint64_t c : map) {
+        EXPECT_FALSE(used[c]);
+        used[c] = true;
+    }
+}
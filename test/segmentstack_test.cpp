@@ -47,6 +47,27 @@ TEST_F(BasicSegmentStackTest, highAlign) {
     pushn(0, 6);
     EXPECT_TRUE(s->isAligned());
 }
+TEST(BasicSegmentStackCheckpointTest, checkpoints) {
+    BasicSegmentStack *s = new BasicSegmentStack(3, 2);
+    pushn(0, 15);
+    popexp(6, 0);
+    // two dropped segments are kept as checkpoints
+    EXPECT_TRUE(s->restoreCheckpoint());
+    for (uint64_t a = 8; a >= 6; a--) {
+        EXPECT_EQ(s->pop(&r), 0);
+        EXPECT_EQ(r.first, a);
+    }
+    EXPECT_TRUE(s->restoreCheckpoint());
+    popexp(3, 0);
+    EXPECT_EQ(s->pop(&r), DFS_DO_RESTORE);
+    EXPECT_FALSE(s->restoreCheckpoint());
+    // the trailer belongs to the segment below the checkpoints
+    s->saveTrailer();
+    s->dropAll();
+    pushn(0, 3);
+    EXPECT_TRUE(s->isAligned());
+    delete s;
+}
 
 class ExtendedSegmentStackTest : public ::testing::Test {
  protected:
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sealib/collection/subgraphstack.h>
 #include <sealib/graph/graphcreator.h>
+#include "testgraphs.h"
 
 using Sealib::SubGraphStack;
 using Sealib::SubGraph;
@@ -10,6 +11,7 @@ using Sealib::Bitset;
 using Sealib::UndirectedGraph;
 using Sealib::GraphCreator;
 using std::shared_ptr;
+using Sealib::TestGraphs::pushThinned;
 
 TEST(SubGraphStackTest, pushPop) {
     typedef Sealib::Bitset<uint8_t> bitset_t;
@@ -146,3 +148,152 @@ TEST(SubGraphStackTest, orderDegree) {
     }
     ASSERT_EQ(stack.size(), 1);
 }
+
+static void expectSameTranslations(SubGraphStack const &s,
+                                   SubGraphStack const &t) {
+    for (uint64_t i = 0; i < s.size(); i++) {
+        for (uint64_t j = 0; j < s.size(); j++) {
+            for (uint64_t u = 1; u <= s.order(i); u++) {
+                ASSERT_EQ(s.phi(i, j, u), t.phi(i, j, u)) << i << " " << j;
+            }
+            for (uint64_t a = 1; a <= s.gMax(i); a++) {
+                ASSERT_EQ(s.psi(i, j, a), t.psi(i, j, a)) << i << " " << j;
+            }
+        }
+    }
+}
+
+TEST(SubGraphStackTest, tuning) {
+    shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(200, 4)));
+    SubGraphStack stack(bg), reference(bg), small(bg);
+    stack.setTuningBudget(1 << 20);
+    reference.setTuningBudget(0);
+    small.setTuningBudget(1500);
+    for (uint64_t i = 0; i < 6; i++) {
+        pushThinned(&stack, 5 + i);
+        pushThinned(&reference, 5 + i);
+        pushThinned(&small, 5 + i);
+    }
+    EXPECT_EQ(stack.tuningByteSize(), 0);
+    // the first pass builds the direct translations, the second one uses them
+    expectSameTranslations(stack, reference);
+    uint64_t tuned = stack.tuningByteSize();
+    EXPECT_GT(tuned, 0);
+    expectSameTranslations(stack, reference);
+    EXPECT_EQ(reference.tuningByteSize(), 0);
+    expectSameTranslations(small, reference);
+    expectSameTranslations(small, reference);
+    EXPECT_GT(small.tuningByteSize(), 0);
+    EXPECT_LE(small.tuningByteSize(), 1500);
+
+    // popping drops the translations of the top graph
+    stack.pop();
+    reference.pop();
+    EXPECT_LT(stack.tuningByteSize(), tuned);
+    pushThinned(&stack, 3);
+    pushThinned(&reference, 3);
+    expectSameTranslations(stack, reference);
+
+    stack.toptune();
+    reference.toptune();
+    expectSameTranslations(stack, reference);
+    EXPECT_GT(reference.tuningByteSize(), 0);
+}
+
+TEST(SubGraphStackTest, referencePolicies) {
+    shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(100, 6)));
+    SubGraphStack tower(bg), flat(bg, SubGraphStack::geometric(1)),
+        wide(bg, SubGraphStack::geometric(3)),
+        custom(bg, [](uint64_t r) { return r + 5; });
+    for (SubGraphStack *s : {&tower, &flat, &wide, &custom}) {
+        s->setTuningBudget(0);
+        pushThinned(s, 3);
+        // more levels than the fixed reference tower had room for with flat
+        for (uint64_t i = 0; i < 30; i++) {
+            pushThinned(s, s->gMax());
+        }
+        EXPECT_EQ(s->size(), 32);
+    }
+    for (SubGraphStack *s : {&flat, &wide, &custom}) {
+        expectSameTranslations(*s, tower);
+        for (uint64_t i = 0; i < s->size(); i++) {
+            ASSERT_EQ(s->gMax(i), tower.gMax(i));
+            for (uint64_t u = 1; u <= s->order(i); u++) {
+                for (uint64_t k = 1; k <= s->degree(i, u); k++) {
+                    EXPECT_EQ(s->head(i, u, k), tower.head(i, u, k));
+                    EXPECT_EQ(s->mate(i, u, k), tower.mate(i, u, k));
+                }
+            }
+        }
+    }
+    // every graph of the flat stack is stored relative to its parent
+    EXPECT_LE(flat.byteSize(), tower.byteSize());
+
+    for (uint64_t i = 0; i < 31; i++) {
+        flat.pop();
+    }
+    pushThinned(&flat, 4);
+    tower.pop();
+    EXPECT_EQ(flat.size(), 2);
+}
+
+TEST(SubGraphStackTest, pushPredicates) {
+    shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(150, 6)));
+    SubGraphStack stack(bg), reference(bg);
+    // levels 4 and 5 are not stored relative to their parent
+    for (uint64_t l = 0; l < 5; l++) {
+        pushThinned(&reference, 7 + l);
+        uint64_t top = reference.size() - 1;
+        Bitset<uint8_t> v(stack.order()), a(stack.gMax());
+        for (uint64_t u = 1; u <= stack.order(); u++) {
+            v[u - 1] = reference.phi(top - 1, top, u) != 0;
+        }
+        for (uint64_t r = 1; r <= stack.gMax(); r++) {
+            a[r - 1] = reference.psi(top - 1, top, r) != 0;
+        }
+        uint64_t calls = 0;
+        stack.push(
+            [&v, &calls](uint64_t u) -> bool {
+                calls++;
+                return v[u - 1];
+            },
+            [&a, &stack, &calls](uint64_t u, uint64_t k) -> bool {
+                calls++;
+                EXPECT_LE(k, stack.degree(u));
+                return a[stack.g(u, k) - 1];
+            });
+        EXPECT_LE(calls, v.size() + a.size());
+    }
+    expectSameTranslations(stack, reference);
+
+    // induced subgraph: drop every third vertex of the top graph
+    Bitset<uint8_t> v(stack.order());
+    for (uint64_t u = 0; u < v.size(); u++) {
+        v[u] = u % 3 != 0;
+    }
+    stack.pushInduced(v);
+    uint64_t top = stack.size() - 1;
+    uint64_t arcs = 0;
+    for (uint64_t u = 1; u <= stack.order(top - 1); u++) {
+        uint64_t w = stack.phi(top - 1, top, u);
+        EXPECT_EQ(w != 0, v[u - 1]);
+        if (w == 0) continue;
+        uint64_t deg = 0;
+        for (uint64_t k = 1; k <= stack.degree(top - 1, u); k++) {
+            if (v[stack.head(top - 1, u, k) - 1]) deg++;
+        }
+        EXPECT_EQ(stack.degree(top, w), deg);
+        for (uint64_t k = 1; k <= stack.degree(top, w); k++) {
+            EXPECT_EQ(stack.phi(top, top - 1, stack.head(top, w, k)),
+                      stack.head(top - 1, u,
+                                 std::get<1>(stack.gInv(
+                                     top - 1, stack.psi(top, top - 1,
+                                                        stack.g(top, w, k))))));
+        }
+        arcs += deg;
+    }
+    EXPECT_EQ(stack.gMax(), arcs);
+}
@@ -0,0 +1,103 @@
+#include "sealib/graph/subgraphview.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "sealib/graph/graphcreator.h"
+#include "sealib/iterator/bfs.h"
+#include "sealib/iterator/dfs.h"
+#include "sealib/iterator/eulertrail.h"
+#include "../src/trail/trailstructure.h"
+#include "testgraphs.h"
+
+using namespace Sealib;  // NOLINT
+using TestGraphs::pushThinned;
+
+// Copy G_i into an adjacency list graph
+static UndirectedGraph copyLevel(SubGraphStack const &stack, uint64_t i) {
+    std::vector<ExtendedNode> nodes(stack.order(i));
+    for (uint64_t u = 1; u <= stack.order(i); u++) {
+        for (uint64_t k = 1; k <= stack.degree(i, u); k++) {
+            std::tuple<uint64_t, uint64_t> m = stack.mate(i, u, k);
+            nodes[u - 1].addAdjacency(
+                {stack.head(i, u, k) - 1, std::get<1>(m) - 1});
+        }
+    }
+    return UndirectedGraph(std::move(nodes));
+}
+
+TEST(SubGraphViewTest, adjacency) {
+    std::shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(300, 6)));
+    SubGraphStack stack(bg);
+    for (uint64_t l = 0; l < 4; l++) {
+        pushThinned(&stack, 4 + l);
+    }
+    for (uint64_t i = 0; i < stack.size(); i++) {
+        SubGraphView v(stack, i);
+        UndirectedGraph g = copyLevel(stack, i);
+        EXPECT_EQ(v.getLevel(), i);
+        ASSERT_EQ(v.getOrder(), g.getOrder());
+        for (uint64_t u = 0; u < v.getOrder(); u++) {
+            ASSERT_EQ(v.deg(u), g.deg(u));
+            for (uint64_t k = 0; k < v.deg(u); k++) {
+                EXPECT_EQ(v.head(u, k), g.head(u, k));
+                EXPECT_EQ(v.mate(u, k), g.mate(u, k));
+                EXPECT_EQ(v.head(v.head(u, k), v.mate(u, k)), u);
+            }
+        }
+    }
+    EXPECT_EQ(SubGraphView(stack).getLevel(), stack.size() - 1);
+}
+
+TEST(SubGraphViewTest, traversals) {
+    std::shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(500, 4)));
+    SubGraphStack stack(bg);
+    pushThinned(&stack, 3);
+    pushThinned(&stack, 5);
+    SubGraphView v(stack);
+    UndirectedGraph g = copyLevel(stack, stack.size() - 1);
+
+    std::vector<uint64_t> c1, c2;
+    DFS::nplusmBitDFS(g, [&c1](uint64_t u) { c1.push_back(u); },
+                      DFS_NOP_EXPLORE, DFS_NOP_EXPLORE,
+                      [&c1](uint64_t u) { c1.push_back(u); });
+    DFS::nplusmBitDFS(v, [&c2](uint64_t u) { c2.push_back(u); },
+                      DFS_NOP_EXPLORE, DFS_NOP_EXPLORE,
+                      [&c2](uint64_t u) { c2.push_back(u); });
+    EXPECT_EQ(c1, c2);
+
+    c1.clear();
+    c2.clear();
+    BFS(g, BFS_NOP_PROCESS, BFS_NOP_EXPLORE)
+        .forEach([&c1](std::pair<uint64_t, uint64_t> p) {
+            c1.push_back(p.first);
+        });
+    BFS(v, BFS_NOP_PROCESS, BFS_NOP_EXPLORE)
+        .forEach([&c2](std::pair<uint64_t, uint64_t> p) {
+            c2.push_back(p.first);
+        });
+    EXPECT_EQ(c1, c2);
+}
+
+// The trail algorithms walk the graph through head() and mate() only, so they
+// give the same result on a view and on a copy of the level
+TEST(SubGraphViewTest, eulerTrail) {
+    std::shared_ptr<UndirectedGraph> bg(
+        new UndirectedGraph(GraphCreator::kRegular(400, 6)));
+    SubGraphStack stack(bg);
+    pushThinned(&stack, 3);
+    pushThinned(&stack, 7);
+    std::shared_ptr<UndirectedGraph> v(new SubGraphView(stack)),
+        g(new UndirectedGraph(copyLevel(stack, stack.size() - 1)));
+    std::vector<std::tuple<uint64_t, bool>> t1, t2;
+    for (std::tuple<uint64_t, bool> x : EulerTrail<TrailStructure>(g)) {
+        t1.push_back(x);
+    }
+    for (std::tuple<uint64_t, bool> x : EulerTrail<TrailStructure>(v)) {
+        t2.push_back(x);
+    }
+    EXPECT_FALSE(t1.empty());
+    EXPECT_EQ(t1, t2);
+}
@@ -0,0 +1,45 @@
+#ifndef TEST_TESTGRAPHS_H_
+#define TEST_TESTGRAPHS_H_
+#include <tuple>
+#include "sealib/collection/subgraphstack.h"
+#include "sealib/graph/undirectedgraph.h"
+
+/**
+ * Helpers that build the test graphs shared by several tests.
+ */
+namespace Sealib {
+namespace TestGraphs {
+
+/**
+ * Append the edge {u,v} to the adjacency lists of u and v.
+ */
+inline void addEdge(UndirectedGraph *g, uint64_t u, uint64_t v) {
+    uint64_t i1 = g->deg(u), i2 = g->deg(v);
+    g->getNode(u).addAdjacency({v, i2});
+    g->getNode(v).addAdjacency({u, i1});
+}
+
+/**
+ * Push a subgraph that removes every k-th edge of the top graph (and the mate
+ * of each removed arc).
+ */
+inline void pushThinned(SubGraphStack *stack, uint64_t k) {
+    Bitset<uint8_t> a(stack->gMax());
+    for (uint64_t j = 0; j < a.size(); j++) {
+        a[j] = 1;
+    }
+    for (uint64_t j = 0; j < a.size(); j++) {
+        if (j % k == 0) {
+            std::tuple<uint64_t, uint64_t> gInv = stack->gInv(j + 1);
+            std::tuple<uint64_t, uint64_t> mate =
+                stack->mate(std::get<0>(gInv), std::get<1>(gInv));
+            a[j] = 0;
+            a[stack->g(std::get<0>(mate), std::get<1>(mate)) - 1] = 0;
+        }
+    }
+    stack->push(a);
+}
+
+}  // namespace TestGraphs
+}  // namespace Sealib
+#endif  // TEST_TESTGRAPHS_H_
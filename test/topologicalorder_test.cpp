@@ -0,0 +1,107 @@
+#include "sealib/iterator/topologicalorder.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "sealib/graph/directedgraph.h"
+
+using namespace Sealib;  // NOLINT
+
+/**
+ * @return a random DAG: arcs only go from lower to higher ranks, and the
+ * ranks are a random permutation of the vertices
+ */
+static DirectedGraph randomDAG(uint64_t n, uint64_t arcs, uint64_t seed) {
+    std::mt19937_64 rnd(seed);
+    std::vector<uint64_t> rank(n);
+    for (uint64_t u = 0; u < n; u++) rank[u] = u;
+    std::shuffle(rank.begin(), rank.end(), rnd);
+    DirectedGraph g(n);
+    std::uniform_int_distribution<uint64_t> dist(0, n - 1);
+    for (uint64_t a = 0; a < arcs; a++) {
+        uint64_t x = dist(rnd), y = dist(rnd);
+        if (x == y) continue;
+        if (x > y) std::swap(x, y);
+        g.getNode(rank[x]).addAdjacency(rank[y]);
+    }
+    return g;
+}
+
+static std::vector<uint64_t> sorted(TopologicalOrder *t) {
+    std::vector<uint64_t> order;
+    t->init();
+    while (t->more()) order.push_back(t->next());
+    return order;
+}
+
+/**
+ * @return true if v reaches u
+ */
+static bool reaches(DirectedGraph const &g, uint64_t v, uint64_t u) {
+    std::vector<bool> seen(g.getOrder());
+    std::vector<uint64_t> s{v};
+    seen[v] = true;
+    while (!s.empty()) {
+        uint64_t x = s.back();
+        s.pop_back();
+        if (x == u) return true;
+        for (uint64_t k = 0; k < g.deg(x); k++) {
+            uint64_t y = g.head(x, k);
+            if (!seen[y]) {
+                seen[y] = true;
+                s.push_back(y);
+            }
+        }
+    }
+    return false;
+}
+
+TEST(TopologicalOrderTest, acyclic) {
+    for (uint64_t seed = 0; seed < 5; seed++) {
+        DirectedGraph g = randomDAG(2000, 10000, seed);
+        TopologicalOrder t(g);
+        std::vector<uint64_t> order = sorted(&t);
+        EXPECT_FALSE(t.hasCycle());
+        ASSERT_EQ(order.size(), g.getOrder());
+        std::vector<uint64_t> position(g.getOrder(), INVALID);
+        for (uint64_t i = 0; i < order.size(); i++) {
+            EXPECT_EQ(position[order[i]], INVALID);
+            position[order[i]] = i;
+        }
+        for (uint64_t u = 0; u < g.getOrder(); u++) {
+            for (uint64_t k = 0; k < g.deg(u); k++) {
+                EXPECT_LT(position[u], position[g.head(u, k)]);
+            }
+        }
+    }
+}
+
+TEST(TopologicalOrderTest, cycle) {
+    for (uint64_t seed = 0; seed < 5; seed++) {
+        DirectedGraph g = randomDAG(2000, 10000, seed);
+        // close a cycle: the last vertex of a path points back to its start
+        uint64_t u = 0;
+        while (g.deg(u) == 0) u++;
+        uint64_t v = g.head(u, 0);
+        while (g.deg(v) > 0) v = g.head(v, 0);
+        g.getNode(v).addAdjacency(u);
+
+        TopologicalOrder t(g);
+        std::vector<uint64_t> order = sorted(&t);
+        ASSERT_TRUE(t.hasCycle());
+        EXPECT_LT(order.size(), g.getOrder());
+        std::pair<uint64_t, uint64_t> a = t.getBackArc();
+        EXPECT_TRUE(reaches(g, a.second, a.first));
+        EXPECT_FALSE(t.more());
+    }
+}
+
+TEST(TopologicalOrderTest, selfLoop) {
+    DirectedGraph g(3);
+    g.getNode(0).addAdjacency(1);
+    g.getNode(1).addAdjacency(1);
+    TopologicalOrder t(g);
+    sorted(&t);
+    EXPECT_TRUE(t.hasCycle());
+    EXPECT_EQ(t.getBackArc(), std::make_pair(uint64_t{1}, uint64_t{1}));
+}
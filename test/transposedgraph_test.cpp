@@ -0,0 +1,44 @@
+#include "sealib/graph/transposedgraph.h"
+#include <gtest/gtest.h>
+#include "sealib/graph/graphcreator.h"
+
+using namespace Sealib;  // NOLINT
+
+static void checkTranspose(DirectedGraph const &g) {
+    DirectedGraph t1 = GraphCreator::transpose(g);
+    TransposedGraph t2(g);
+    ASSERT_EQ(t2.getOrder(), t1.getOrder());
+    for (uint64_t u = 0; u < t1.getOrder(); u++) {
+        ASSERT_EQ(t2.deg(u), t1.deg(u));
+        for (uint64_t k = 0; k < t1.deg(u); k++) {
+            EXPECT_EQ(t2.head(u, k), t1.head(u, k));
+        }
+    }
+}
+
+TEST(TransposedGraphTest, adjacency) {
+    checkTranspose(GraphCreator::kOutdegree(2000, 5));
+    checkTranspose(GraphCreator::imbalanced(500));
+}
+
+TEST(TransposedGraphTest, isolatedVertices) {
+    // vertex 0 has no in-arcs, vertex 3 no arcs at all
+    DirectedGraph g(5);
+    g.getNode(0).addAdjacency(1);
+    g.getNode(0).addAdjacency(2);
+    g.getNode(2).addAdjacency(1);
+    g.getNode(4).addAdjacency(4);
+    g.getNode(1).addAdjacency(4);
+    checkTranspose(g);
+    TransposedGraph t(g);
+    EXPECT_EQ(t.deg(0), 0);
+    EXPECT_EQ(t.deg(3), 0);
+    EXPECT_EQ(t.deg(4), 2);
+}
+
+TEST(TransposedGraphTest, smallerThanTranspose) {
+    DirectedGraph g = GraphCreator::kOutdegree(10000, 20);
+    TransposedGraph t(g);
+    // a word per arc in the adjacency list transpose
+    EXPECT_LT(t.byteSize(), 10000 * 20 * sizeof(uint64_t) / 2);
+}